@@ -0,0 +1,607 @@
+#include "../Core/stdafx.h"
+#include <chrono>
+#include "../Core/Console.h"
+#include "../Core/EmuSettings.h"
+#include "../Core/SettingTypes.h"
+#include "../Core/BatteryManager.h"
+#include "../Core/PerfCounters.h"
+#include "../Core/MovieManager.h"
+#include "../Core/BaseCartridge.h"
+#include "../Core/Ppu.h"
+#include "../Core/Gameboy.h"
+#include "../Core/GbPpu.h"
+#include "../Core/HeadlessConsole.h"
+#include "../Core/HeadlessScheduler.h"
+#include "../Core/HeadlessConsoleTest.h"
+#include "../Utilities/FolderUtilities.h"
+#include "../Utilities/VirtualFile.h"
+#include "../Utilities/StringUtilities.h"
+#include "../Utilities/md5.h"
+#include "../Utilities/HermiteResampler.h"
+#include "../Utilities/SincResampler.h"
+
+#if __has_include(<filesystem>)
+	#include <filesystem>
+	namespace fs = std::filesystem;
+#elif __has_include(<experimental/filesystem>)
+	#include <experimental/filesystem>
+	namespace fs = std::experimental::filesystem;
+#endif
+
+using std::chrono::high_resolution_clock;
+
+struct BenchOptions
+{
+	uint32_t FrameCount = 3600;
+	bool FrameCountSet = false;
+	uint32_t WarmupFrames = 60;
+	bool EnablePerfCounters = true;
+	bool NoVideo = false;
+	bool CsvOutput = false;
+	bool ResamplerBench = false;
+	bool InputCheck = false;
+	uint32_t InstanceCount = 1;
+	uint32_t ThreadCount = 0;
+	string HomeFolder = "MesenBenchHome";
+	string MovieFile;
+	string SuiteFile;
+	vector<string> Paths;
+};
+
+struct BenchEntry
+{
+	string RomFile;
+	string MovieFile;
+	string ExpectedHash;
+};
+
+struct BenchResult
+{
+	string RomName;
+	string Coprocessor;
+	string FrameHash;
+	string Status;
+	uint32_t FrameCount = 0;
+	double TotalSeconds = 0;
+	double P50 = 0;
+	double P99 = 0;
+	double SubsystemUs[(int)PerfCounterType::Count] = {};
+	double OtherUs = 0;
+};
+
+static void PrintUsage()
+{
+	std::cout << "Usage: mesens-bench [options] <rom file or folder>..." << std::endl;
+	std::cout << "       mesens-bench [options] --movie <movie.msm> <rom file>" << std::endl;
+	std::cout << "       mesens-bench [options] --suite <suite file>" << std::endl;
+	std::cout << "       mesens-bench [--csv] --resampler" << std::endl;
+	std::cout << "       mesens-bench --input-check <rom file>..." << std::endl;
+	std::cout << "  --frames <n>    Number of frames to measure per rom (default: 3600, or the whole movie)" << std::endl;
+	std::cout << "  --warmup <n>    Number of frames to run before measuring (default: 60, ignored for movies)" << std::endl;
+	std::cout << "  --movie <file>  Replay a movie as fast as possible and report the final frame's hash" << std::endl;
+	std::cout << "  --suite <file>  Replay each \"rom|movie|expected hash\" entry listed in the file (one per line)" << std::endl;
+	std::cout << "  --instances <n> Run n copies of each rom in parallel and report the aggregated fps (default: 1)" << std::endl;
+	std::cout << "  --threads <n>   Number of threads used with --instances (default: one per core)" << std::endl;
+	std::cout << "  --home <path>   Mesen-S home folder (firmware, etc.) (default: ./MesenBenchHome)" << std::endl;
+	std::cout << "  --no-profile    Do not measure the time spent in each subsystem" << std::endl;
+	std::cout << "  --no-video      Only render the last frame (not available with --movie or --suite)" << std::endl;
+	std::cout << "  --resampler     Measure the cost of each audio resampler (no rom needed)" << std::endl;
+	std::cout << "  --input-check   Check that headless consoles still receive their input after a power cycle/reset" << std::endl;
+	std::cout << "  --csv           Output results as CSV" << std::endl;
+}
+
+static bool ParseOptions(int argc, char* argv[], BenchOptions &options)
+{
+	for(int i = 1; i < argc; i++) {
+		string arg = argv[i];
+		bool hasValue = i + 1 < argc;
+		if(arg == "--frames" && hasValue) {
+			options.FrameCount = (uint32_t)std::stoul(argv[++i]);
+			options.FrameCountSet = true;
+		} else if(arg == "--warmup" && hasValue) {
+			options.WarmupFrames = (uint32_t)std::stoul(argv[++i]);
+		} else if(arg == "--instances" && hasValue) {
+			options.InstanceCount = (uint32_t)std::stoul(argv[++i]);
+		} else if(arg == "--threads" && hasValue) {
+			options.ThreadCount = (uint32_t)std::stoul(argv[++i]);
+		} else if(arg == "--home" && hasValue) {
+			options.HomeFolder = argv[++i];
+		} else if(arg == "--movie" && hasValue) {
+			options.MovieFile = argv[++i];
+		} else if(arg == "--suite" && hasValue) {
+			options.SuiteFile = argv[++i];
+		} else if(arg == "--no-profile") {
+			options.EnablePerfCounters = false;
+		} else if(arg == "--no-video") {
+			options.NoVideo = true;
+		} else if(arg == "--csv") {
+			options.CsvOutput = true;
+		} else if(arg == "--resampler") {
+			options.ResamplerBench = true;
+		} else if(arg == "--input-check") {
+			options.InputCheck = true;
+		} else if(arg.size() > 0 && arg[0] == '-') {
+			return false;
+		} else {
+			options.Paths.push_back(arg);
+		}
+	}
+
+	if(options.ResamplerBench) {
+		return options.Paths.empty() && options.SuiteFile.empty() && options.MovieFile.empty();
+	} else if(options.InputCheck) {
+		return !options.Paths.empty() && options.SuiteFile.empty() && options.MovieFile.empty();
+	}
+
+	if(options.InstanceCount > 1) {
+		//Per-subsystem timings are not meaningful when several consoles share the host's cores
+		options.EnablePerfCounters = false;
+		if(!options.SuiteFile.empty() || !options.MovieFile.empty()) {
+			return false;
+		}
+	}
+
+	if(options.NoVideo && (!options.SuiteFile.empty() || !options.MovieFile.empty())) {
+		//The movie's last frame is not known in advance, so its hash could not be calculated
+		return false;
+	}
+
+	if(!options.SuiteFile.empty()) {
+		return options.Paths.empty();
+	} else if(!options.MovieFile.empty()) {
+		return options.Paths.size() == 1;
+	}
+	return !options.Paths.empty() && options.FrameCount > 0 && options.InstanceCount > 0;
+}
+
+static vector<BenchEntry> GetRomFiles(vector<string> paths)
+{
+	std::unordered_set<string> extensions = VirtualFile::RomExtensions;
+	vector<BenchEntry> entries;
+	vector<string> files;
+	for(string &path : paths) {
+		std::error_code errorCode;
+		if(fs::is_directory(fs::u8path(path), errorCode)) {
+			vector<string> folderFiles;
+			for(fs::directory_iterator i(fs::u8path(path)), end; i != end; i++) {
+				string extension = i->path().extension().u8string();
+				std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+				if(extensions.find(extension) != extensions.end()) {
+					folderFiles.push_back(i->path().u8string());
+				}
+			}
+			//Sort to keep the output order stable between runs
+			std::sort(folderFiles.begin(), folderFiles.end());
+			files.insert(files.end(), folderFiles.begin(), folderFiles.end());
+		} else {
+			files.push_back(path);
+		}
+	}
+
+	for(string &file : files) {
+		entries.push_back({ file, "", "" });
+	}
+	return entries;
+}
+
+static bool LoadSuite(string suiteFile, vector<BenchEntry> &entries)
+{
+	ifstream file(suiteFile);
+	if(!file) {
+		return false;
+	}
+
+	//Rom and movie paths are relative to the suite file's folder
+	fs::path suiteFolder = fs::u8path(suiteFile).parent_path();
+	string line;
+	while(std::getline(file, line)) {
+		line.erase(std::remove(line.begin(), line.end(), '\r'), line.end());
+		if(line.empty() || line[0] == '#') {
+			continue;
+		}
+
+		vector<string> fields = StringUtilities::Split(line, '|');
+		if(fields.size() < 2) {
+			std::cerr << "Invalid suite entry: " << line << std::endl;
+			return false;
+		}
+
+		BenchEntry entry;
+		entry.RomFile = (suiteFolder / fs::u8path(fields[0])).u8string();
+		entry.MovieFile = (suiteFolder / fs::u8path(fields[1])).u8string();
+		entry.ExpectedHash = fields.size() >= 3 ? fields[2] : "";
+		entries.push_back(entry);
+	}
+	return true;
+}
+
+static string GetCoprocessorName(CoprocessorType type)
+{
+	switch(type) {
+		case CoprocessorType::None: return "None";
+		case CoprocessorType::CX4: return "CX4";
+		case CoprocessorType::SDD1: return "S-DD1";
+		case CoprocessorType::DSP1: return "DSP1";
+		case CoprocessorType::DSP1B: return "DSP1B";
+		case CoprocessorType::DSP2: return "DSP2";
+		case CoprocessorType::DSP3: return "DSP3";
+		case CoprocessorType::DSP4: return "DSP4";
+		case CoprocessorType::GSU: return "GSU";
+		case CoprocessorType::OBC1: return "OBC1";
+		case CoprocessorType::RTC: return "RTC";
+		case CoprocessorType::SA1: return "SA1";
+		case CoprocessorType::Satellaview: return "Satellaview";
+		case CoprocessorType::SPC7110: return "SPC7110";
+		case CoprocessorType::ST010: return "ST010";
+		case CoprocessorType::ST011: return "ST011";
+		case CoprocessorType::ST018: return "ST018";
+		case CoprocessorType::Gameboy: return "GB";
+		case CoprocessorType::SGB: return "SGB";
+	}
+	return "";
+}
+
+static string GetFrameHash(shared_ptr<Console> console)
+{
+	if(console->GetSettings()->CheckFlag(EmulationFlags::GameboyMode)) {
+		GbPpu* ppu = console->GetCartridge()->GetGameboy()->GetPpu();
+		return GetMd5Sum(ppu->GetOutputBuffer(), 160 * 144 * sizeof(uint16_t));
+	} else {
+		shared_ptr<Ppu> ppu = console->GetPpu();
+		bool highRes = ppu->IsHighResOutput();
+		uint16_t width = highRes ? 512 : 256;
+		uint16_t height = highRes ? 478 : 239;
+		return GetMd5Sum(ppu->GetScreenBuffer(), width * height * sizeof(uint16_t));
+	}
+}
+
+static void ApplyBenchSettings(shared_ptr<Console> console, BenchOptions &options)
+{
+	shared_ptr<EmuSettings> settings = console->GetSettings();
+	settings->SetFlagState(EmulationFlags::NoVideo, options.NoVideo);
+
+	//Make each run deterministic and avoid any frame skipping
+	EmulationConfig emuCfg = settings->GetEmulationConfig();
+	emuCfg.RamPowerOnState = RamState::AllZeros;
+	emuCfg.EmulationSpeed = 100;
+	emuCfg.RunAheadFrames = 0;
+	settings->SetEmulationConfig(emuCfg);
+
+	VideoConfig videoCfg = settings->GetVideoConfig();
+	videoCfg.DisableFrameSkipping = true;
+	settings->SetVideoConfig(videoCfg);
+
+	PreferencesConfig preferences = settings->GetPreferences();
+	preferences.DisableOsd = true;
+	preferences.RewindBufferSize = 0;
+	settings->SetPreferences(preferences);
+}
+
+static bool RunBenchmark(BenchEntry &entry, BenchOptions &options, BenchResult &result)
+{
+	bool isMovie = !entry.MovieFile.empty();
+	shared_ptr<Console> console(new Console());
+	console->Initialize();
+	ApplyBenchSettings(console, options);
+
+	if(!console->LoadRom((VirtualFile)entry.RomFile, VirtualFile())) {
+		console->Release();
+		return false;
+	}
+
+	shared_ptr<MovieManager> movieManager = console->GetMovieManager();
+	if(isMovie) {
+		//Power cycles the console and applies the movie's settings (region, controllers, power on state)
+		movieManager->Play(VirtualFile(entry.MovieFile));
+		if(!movieManager->Playing()) {
+			std::cerr << "Could not play movie: " << entry.MovieFile << std::endl;
+			console->Stop(false);
+			console->Release();
+			return false;
+		}
+	}
+
+	//Never write battery files, to keep runs repeatable
+	console->GetBatteryManager()->SetSaveEnabled(false);
+
+	if(!isMovie) {
+		for(uint32_t i = 0; i < options.WarmupFrames; i++) {
+			console->RunSingleFrame();
+		}
+	}
+
+	console->SetPerfCountersEnabled(options.EnablePerfCounters);
+
+	uint32_t maxFrames = (isMovie && !options.FrameCountSet) ? UINT32_MAX : options.FrameCount;
+	vector<double> frameTimes;
+	frameTimes.reserve(isMovie ? 0x10000 : maxFrames);
+
+	high_resolution_clock::time_point start = high_resolution_clock::now();
+	high_resolution_clock::time_point frameStart = start;
+	for(uint32_t i = 0; i < maxFrames; i++) {
+		if(isMovie && !movieManager->Playing()) {
+			break;
+		}
+
+		if(i == maxFrames - 1) {
+			//Render the last frame (in no-video mode), for its hash
+			console->RenderNextFrame();
+		}
+		console->RunSingleFrame();
+		high_resolution_clock::time_point frameEnd = high_resolution_clock::now();
+		frameTimes.push_back(std::chrono::duration<double, std::micro>(frameEnd - frameStart).count());
+		frameStart = frameEnd;
+	}
+
+	if(frameTimes.empty()) {
+		movieManager->Stop();
+		console->Stop(false);
+		console->Release();
+		return false;
+	}
+
+	result.RomName = FolderUtilities::GetFilename(isMovie ? entry.MovieFile : entry.RomFile, true);
+	result.Coprocessor = GetCoprocessorName(console->GetRomInfo().Coprocessor);
+	result.FrameHash = GetFrameHash(console);
+	if(!entry.ExpectedHash.empty()) {
+		result.Status = entry.ExpectedHash == result.FrameHash ? "OK" : "FAIL";
+	}
+	result.FrameCount = (uint32_t)frameTimes.size();
+	result.TotalSeconds = std::chrono::duration<double>(frameStart - start).count();
+
+	std::sort(frameTimes.begin(), frameTimes.end());
+	result.P50 = frameTimes[(frameTimes.size() - 1) / 2];
+	result.P99 = frameTimes[(size_t)((frameTimes.size() - 1) * 0.99)];
+
+	PerfCounters* counters = console->GetPerfCounters();
+	if(counters) {
+		double totalUs = result.TotalSeconds * 1000000 / result.FrameCount;
+		result.OtherUs = totalUs;
+		for(int i = 0; i < (int)PerfCounterType::Count; i++) {
+			result.SubsystemUs[i] = counters->GetElapsedNs((PerfCounterType)i) / 1000.0 / result.FrameCount;
+			result.OtherUs -= result.SubsystemUs[i];
+		}
+	}
+
+	console->SetPerfCountersEnabled(false);
+	movieManager->Stop();
+	console->Stop(false);
+	console->Release();
+	return true;
+}
+
+static bool RunParallelBenchmark(BenchEntry &entry, BenchOptions &options, BenchResult &result)
+{
+	vector<unique_ptr<HeadlessConsole>> instances;
+	vector<HeadlessConsole*> batch;
+	for(uint32_t i = 0; i < options.InstanceCount; i++) {
+		unique_ptr<HeadlessConsole> instance(new HeadlessConsole());
+		ApplyBenchSettings(instance->GetConsole(), options);
+		if(!instance->LoadRom((VirtualFile)entry.RomFile)) {
+			return false;
+		}
+		instance->GetConsole()->GetBatteryManager()->SetSaveEnabled(false);
+		batch.push_back(instance.get());
+		instances.push_back(std::move(instance));
+	}
+
+	HeadlessScheduler scheduler(options.ThreadCount);
+	vector<HeadlessFrame> frames;
+	for(uint32_t i = 0; i < options.WarmupFrames; i++) {
+		scheduler.RunFrame(batch, frames);
+	}
+
+	//Frame times are measured per batch (the time it takes for all instances to run a frame)
+	vector<double> frameTimes;
+	frameTimes.reserve(options.FrameCount);
+
+	high_resolution_clock::time_point start = high_resolution_clock::now();
+	high_resolution_clock::time_point frameStart = start;
+	for(uint32_t i = 0; i < options.FrameCount; i++) {
+		if(i == options.FrameCount - 1) {
+			//Render the last frame (in no-video mode), for its hash
+			instances[0]->RenderNextFrame();
+		}
+		scheduler.RunFrame(batch, frames);
+		high_resolution_clock::time_point frameEnd = high_resolution_clock::now();
+		frameTimes.push_back(std::chrono::duration<double, std::micro>(frameEnd - frameStart).count());
+		frameStart = frameEnd;
+	}
+
+	shared_ptr<Console> console = instances[0]->GetConsole();
+	result.RomName = FolderUtilities::GetFilename(entry.RomFile, true) + " x" + std::to_string(options.InstanceCount);
+	result.Coprocessor = GetCoprocessorName(console->GetRomInfo().Coprocessor);
+	result.FrameHash = GetFrameHash(console);
+	result.FrameCount = (uint32_t)frameTimes.size() * options.InstanceCount;
+	result.TotalSeconds = std::chrono::duration<double>(frameStart - start).count();
+
+	std::sort(frameTimes.begin(), frameTimes.end());
+	result.P50 = frameTimes[(frameTimes.size() - 1) / 2];
+	result.P99 = frameTimes[(size_t)((frameTimes.size() - 1) * 0.99)];
+	return true;
+}
+
+static void PrintHeader(BenchOptions &options)
+{
+	if(options.CsvOutput) {
+		std::cout << "rom,coprocessor,frames,seconds,fps,p50_us,p99_us";
+		if(options.EnablePerfCounters) {
+			for(int i = 0; i < (int)PerfCounterType::Count; i++) {
+				std::cout << "," << PerfCounters::GetName((PerfCounterType)i) << "_us";
+			}
+			std::cout << ",Other_us";
+		}
+		std::cout << ",hash,status";
+	} else {
+		std::cout << std::left << std::setw(40) << "ROM" << std::setw(12) << "Coprocessor" << std::right << std::setw(8) << "Frames" << std::setw(10) << "Seconds" << std::setw(10) << "FPS" << std::setw(10) << "p50 us" << std::setw(10) << "p99 us";
+		if(options.EnablePerfCounters) {
+			for(int i = 0; i < (int)PerfCounterType::Count; i++) {
+				std::cout << std::setw(10) << (string(PerfCounters::GetName((PerfCounterType)i)) + " us");
+			}
+			std::cout << std::setw(10) << "Other us";
+		}
+		std::cout << "  " << std::left << std::setw(34) << "Hash" << "Status";
+	}
+	std::cout << std::endl;
+}
+
+static void PrintResult(BenchOptions &options, BenchResult &result)
+{
+	double fps = result.FrameCount / result.TotalSeconds;
+	std::cout << std::fixed << std::setprecision(1);
+	if(options.CsvOutput) {
+		std::cout << "\"" << result.RomName << "\"," << result.Coprocessor << "," << result.FrameCount << "," << result.TotalSeconds << "," << fps << "," << result.P50 << "," << result.P99;
+		if(options.EnablePerfCounters) {
+			for(int i = 0; i < (int)PerfCounterType::Count; i++) {
+				std::cout << "," << result.SubsystemUs[i];
+			}
+			std::cout << "," << result.OtherUs;
+		}
+		std::cout << "," << result.FrameHash << "," << result.Status;
+	} else {
+		string name = result.RomName.size() > 39 ? result.RomName.substr(0, 39) : result.RomName;
+		std::cout << std::left << std::setw(40) << name << std::setw(12) << result.Coprocessor << std::right << std::setw(8) << result.FrameCount << std::setw(10) << result.TotalSeconds << std::setw(10) << fps << std::setw(10) << result.P50 << std::setw(10) << result.P99;
+		if(options.EnablePerfCounters) {
+			for(int i = 0; i < (int)PerfCounterType::Count; i++) {
+				std::cout << std::setw(10) << result.SubsystemUs[i];
+			}
+			std::cout << std::setw(10) << result.OtherUs;
+		}
+		std::cout << "  " << std::left << std::setw(34) << result.FrameHash << result.Status;
+	}
+	std::cout << std::endl;
+}
+
+template<typename T>
+static double MeasureResampler(T &resampler, vector<int16_t> &input, vector<int16_t> &output)
+{
+	//Feed the audio in chunks of roughly one frame's worth of samples (like SoundMixer does), with a small rate variation
+	//on every chunk to mimic the dynamic rate adjustment done by SoundResampler
+	constexpr uint32_t srcRate = 32040;
+	constexpr uint32_t dstRate = 48000;
+	constexpr uint32_t chunkSize = 534;
+
+	resampler.Reset();
+	high_resolution_clock::time_point start = high_resolution_clock::now();
+	uint32_t chunkCount = (uint32_t)(input.size() / 2 / chunkSize);
+	for(uint32_t i = 0; i < chunkCount; i++) {
+		double adjustment = 1.0 + ((int)(i % 17) - 8) * 0.00003125;
+		resampler.SetSampleRates(srcRate, dstRate * adjustment);
+		resampler.Resample(input.data() + i * chunkSize * 2, chunkSize, output.data());
+	}
+	return std::chrono::duration<double>(high_resolution_clock::now() - start).count();
+}
+
+static int RunResamplerBenchmark(BenchOptions &options)
+{
+	constexpr uint32_t seconds = 60;
+	constexpr uint32_t srcRate = 32040;
+
+	//Synthetic stereo signal: a few tones spread over the whole spectrum, plus some noise
+	vector<int16_t> input(seconds * srcRate * 2);
+	uint32_t noise = 1;
+	for(size_t i = 0; i < input.size() / 2; i++) {
+		double t = (double)i / srcRate;
+		noise = noise * 1103515245 + 12345;
+		double value = 6000 * std::sin(t * 440 * 6.2831853) + 4000 * std::sin(t * 3520 * 6.2831853) + 2000 * std::sin(t * 12000 * 6.2831853) + (int)((noise >> 16) & 0x7FF) - 0x400;
+		input[i * 2] = (int16_t)value;
+		input[i * 2 + 1] = (int16_t)-value;
+	}
+	vector<int16_t> output(534 * 2 * 4);
+
+	struct ResamplerEntry { string Name; uint32_t TapCount; };
+	vector<ResamplerEntry> resamplers = { { "Hermite", 0 }, { "Sinc (8 taps)", 8 }, { "Sinc (16 taps)", 16 }, { "Sinc (32 taps)", 32 } };
+
+	std::cout << std::fixed << std::setprecision(1);
+	if(options.CsvOutput) {
+		std::cout << "resampler,seconds,us_per_audio_second,percent_realtime" << std::endl;
+	} else {
+		std::cout << std::left << std::setw(20) << "Resampler" << std::right << std::setw(12) << "Seconds" << std::setw(16) << "us/audio sec" << std::setw(12) << "% realtime" << std::endl;
+	}
+
+	for(ResamplerEntry &entry : resamplers) {
+		double elapsed;
+		if(entry.TapCount == 0) {
+			HermiteResampler resampler;
+			elapsed = MeasureResampler(resampler, input, output);
+		} else {
+			SincResampler resampler;
+			resampler.SetTapCount(entry.TapCount);
+			elapsed = MeasureResampler(resampler, input, output);
+		}
+
+		double usPerSecond = elapsed * 1000000 / seconds;
+		double percent = elapsed * 100 / seconds;
+		if(options.CsvOutput) {
+			std::cout << "\"" << entry.Name << "\"," << seconds << "," << usPerSecond << "," << std::setprecision(3) << percent << std::setprecision(1) << std::endl;
+		} else {
+			std::cout << std::left << std::setw(20) << entry.Name << std::right << std::setw(12) << seconds << std::setw(16) << usPerSecond << std::setw(12) << std::setprecision(3) << percent << std::setprecision(1) << std::endl;
+		}
+	}
+	return 0;
+}
+
+int main(int argc, char* argv[])
+{
+	BenchOptions options;
+	if(!ParseOptions(argc, argv, options)) {
+		PrintUsage();
+		return 1;
+	}
+
+	if(options.ResamplerBench) {
+		return RunResamplerBenchmark(options);
+	}
+
+	FolderUtilities::SetHomeFolder(options.HomeFolder);
+
+	if(options.InputCheck) {
+		int errorCount = 0;
+		for(BenchEntry &entry : GetRomFiles(options.Paths)) {
+			int32_t result = HeadlessConsoleTest::Run((VirtualFile)entry.RomFile);
+			if(result >= 0) {
+				std::cout << std::left << std::setw(40) << FolderUtilities::GetFilename(entry.RomFile, true) << (result == 0 ? "OK" : "FAIL") << std::endl;
+				errorCount += result == 0 ? 0 : 1;
+			} else {
+				std::cerr << "Could not load: " << entry.RomFile << std::endl;
+				errorCount++;
+			}
+		}
+		return errorCount > 0 ? 2 : 0;
+	}
+
+	vector<BenchEntry> entries;
+	if(!options.SuiteFile.empty()) {
+		if(!LoadSuite(options.SuiteFile, entries)) {
+			std::cerr << "Could not load suite: " << options.SuiteFile << std::endl;
+			return 1;
+		}
+	} else if(!options.MovieFile.empty()) {
+		entries.push_back({ options.Paths[0], options.MovieFile, "" });
+	} else {
+		entries = GetRomFiles(options.Paths);
+	}
+
+	if(entries.empty()) {
+		std::cerr << "No roms found." << std::endl;
+		return 1;
+	}
+
+	int errorCount = 0;
+	PrintHeader(options);
+	for(BenchEntry &entry : entries) {
+		BenchResult result;
+		bool loaded = options.InstanceCount > 1 ? RunParallelBenchmark(entry, options, result) : RunBenchmark(entry, options, result);
+		if(loaded) {
+			PrintResult(options, result);
+			if(result.Status == "FAIL") {
+				errorCount++;
+			}
+		} else {
+			std::cerr << "Could not load: " << entry.RomFile << std::endl;
+			errorCount++;
+		}
+	}
+
+	return errorCount > 0 ? 2 : 0;
+}
@@ -44,7 +44,7 @@ shared_ptr<BaseCartridge> BaseCartridge::CreateCartridge(Console* console, Virtu
 		shared_ptr<BaseCartridge> cart(new BaseCartridge());
 		if(patchFile.IsValid()) {
 			cart->_patchPath = patchFile;
-			if(romFile.ApplyPatch(patchFile)) {
+			if(romFile.ApplyPatch(patchFile) && !console->GetSettings()->CheckFlag(EmulationFlags::NoFrontendOutput)) {
 				MessageManager::DisplayMessage("Patch", "ApplyingPatch", patchFile.GetFileName());
 			}
 		}
@@ -231,7 +231,9 @@ void BaseCartridge::LoadRom()
 	_saveRam = new uint8_t[_saveRamSize];
 	_console->GetSettings()->InitializeRam(_saveRam, _saveRamSize);
 
-	DisplayCartInfo();
+	if(!_console->GetSettings()->CheckFlag(EmulationFlags::NoFrontendOutput)) {
+		DisplayCartInfo();
+	}
 }
 
 CoprocessorType BaseCartridge::GetCoprocessorType()
@@ -1,6 +1,11 @@
 #include "stdafx.h"
 #include "BaseSoundManager.h"
 
+BaseSoundManager::BaseSoundManager()
+{
+	_bufferUnderrunEventCount = 0;
+}
+
 void BaseSoundManager::ProcessLatency(uint32_t readPosition, uint32_t writePosition)
 {
 	//Record latency between read & write cursors once per frame
@@ -11,7 +16,27 @@ void BaseSoundManager::ProcessLatency(uint32_t readPosition, uint32_t writePosit
 		cursorGap = writePosition - readPosition;
 	}
 
-	_cursorGaps[_cursorGapIndex] = cursorGap;
+	ProcessLatency((uint32_t)cursorGap);
+}
+
+void BaseSoundManager::ProcessLatency(uint32_t bufferedBytes)
+{
+	uint32_t bytesPerSample = _isStereo ? 4 : 2;
+
+	//Track how much the amount of buffered audio changes from one frame to the next
+	uint32_t latency = bufferedBytes / bytesPerSample;
+	if(_cursorGapIndex > 0 || _cursorGapFilled) {
+		uint32_t change = (uint32_t)std::abs((int32_t)latency - (int32_t)_currentLatency);
+		uint32_t changeMs = _sampleRate ? (uint32_t)((uint64_t)change * 1000 / _sampleRate) : 0;
+		int bucket = 0;
+		while(bucket < AudioStatistics::JitterBucketCount - 1 && changeMs >= (1u << bucket)) {
+			bucket++;
+		}
+		_latencyJitter[bucket]++;
+	}
+	_currentLatency = latency;
+
+	_cursorGaps[_cursorGapIndex] = (int32_t)bufferedBytes;
 	_cursorGapIndex = (_cursorGapIndex + 1) % 60;
 	if(_cursorGapIndex == 0) {
 		_cursorGapFilled = true;
@@ -20,8 +45,6 @@ void BaseSoundManager::ProcessLatency(uint32_t readPosition, uint32_t writePosit
 	if(_cursorGapFilled) {
 		//Once we have 60+ frames worth of data to work with, adjust playback frequency by +/- 0.5%
 		//To speed up or slow down playback in order to reach our latency goal.
-		uint32_t bytesPerSample = _isStereo ? 4 : 2;
-
 		int32_t gapSum = 0;
 		for(int i = 0; i < 60; i++) {
 			gapSum += _cursorGaps[i];
@@ -38,6 +61,8 @@ AudioStatistics BaseSoundManager::GetStatistics()
 	stats.AverageLatency = _averageLatency;
 	stats.BufferUnderrunEventCount = _bufferUnderrunEventCount;
 	stats.BufferSize = _bufferSize;
+	stats.CurrentLatency = _currentLatency;
+	memcpy(stats.LatencyJitter, _latencyJitter, sizeof(_latencyJitter));
 	return stats;
 }
 
@@ -47,4 +72,6 @@ void BaseSoundManager::ResetStats()
 	_cursorGapFilled = false;
 	_bufferUnderrunEventCount = 0;
 	_averageLatency = 0;
+	_currentLatency = 0;
+	memset(_latencyJitter, 0, sizeof(_latencyJitter));
 }
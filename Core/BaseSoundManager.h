@@ -5,6 +5,7 @@ class BaseSoundManager : public IAudioDevice
 {
 public:
 	void ProcessLatency(uint32_t readPosition, uint32_t writePosition);
+	void ProcessLatency(uint32_t bufferedBytes);
 	AudioStatistics GetStatistics();
 
 protected:
@@ -13,11 +14,16 @@ protected:
 
 	double _averageLatency = 0;
 	uint32_t _bufferSize = 0x10000;
-	uint32_t _bufferUnderrunEventCount = 0;
+	atomic<uint32_t> _bufferUnderrunEventCount;
 
 	int32_t _cursorGaps[60];
 	int32_t _cursorGapIndex = 0;
 	bool _cursorGapFilled = false;
 
+	uint32_t _currentLatency = 0;
+	uint32_t _latencyJitter[AudioStatistics::JitterBucketCount] = {};
+
+	BaseSoundManager();
+
 	void ResetStats();
 };
@@ -30,7 +30,7 @@ void CheatManager::AddCheat(CheatCode code)
 	}
 }
 
-void CheatManager::SetCheats(vector<CheatCode> codes)
+void CheatManager::SetCheats(vector<CheatCode> codes, bool showMessage)
 {
 	auto lock = _console->AcquireLock();
 
@@ -40,12 +40,14 @@ void CheatManager::SetCheats(vector<CheatCode> codes)
 		AddCheat(code);
 	}
 
-	if(codes.size() > 1) {
-		MessageManager::DisplayMessage("Cheats", "CheatsApplied", std::to_string(codes.size()));
-	} else if(codes.size() == 1) {
-		MessageManager::DisplayMessage("Cheats", "CheatApplied");
-	} else if(hasCheats) {
-		MessageManager::DisplayMessage("Cheats", "CheatsDisabled");
+	if(showMessage) {
+		if(codes.size() > 1) {
+			MessageManager::DisplayMessage("Cheats", "CheatsApplied", std::to_string(codes.size()));
+		} else if(codes.size() == 1) {
+			MessageManager::DisplayMessage("Cheats", "CheatApplied");
+		} else if(hasCheats) {
+			MessageManager::DisplayMessage("Cheats", "CheatsDisabled");
+		}
 	}
 
 	_console->GetNotificationManager()->SendNotification(ConsoleNotificationType::CheatsChanged);
@@ -25,7 +25,7 @@ public:
 
 	void AddStringCheat(string code);
 
-	void SetCheats(vector<CheatCode> codes);
+	void SetCheats(vector<CheatCode> codes, bool showMessage = true);
 	void SetCheats(uint32_t codes[], uint32_t length);
 	void ClearCheats(bool showMessage = true);
 
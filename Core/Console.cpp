@@ -26,6 +26,7 @@
 #include "EmuSettings.h"
 #include "SaveStateManager.h"
 #include "DebugStats.h"
+#include "PerfCounters.h"
 #include "CartTypes.h"
 #include "RewindManager.h"
 #include "ConsoleLock.h"
@@ -36,6 +37,7 @@
 #include "SystemActionManager.h"
 #include "SpcHud.h"
 #include "Msu1.h"
+#include "RunAheadShadow.h"
 #include "../Utilities/Serializer.h"
 #include "../Utilities/Timer.h"
 #include "../Utilities/VirtualFile.h"
@@ -50,6 +52,7 @@ Console::Console()
 	_pauseOnNextFrame = false;
 	_stopFlag = false;
 	_isRunAheadFrame = false;
+	_renderNextFrame = false;
 	_lockCounter = 0;
 	_threadPaused = false;
 }
@@ -80,6 +83,10 @@ void Console::Release()
 {
 	Stop(true);
 
+	if(KeyManager::IsBoundTo(_settings.get())) {
+		KeyManager::SetSettings(nullptr);
+	}
+
 	_videoDecoder->StopThread();
 	_videoRenderer->StopThread();
 	
@@ -136,7 +143,11 @@ void Console::Run()
 
 	while(!_stopFlag) {
 		bool useRunAhead = _settings->GetEmulationConfig().RunAheadFrames > 0 && !_debugger && !_rewindManager->IsRewinding() && _settings->GetEmulationSpeed() > 0 && _settings->GetEmulationSpeed() <= 100;
-		if(useRunAhead) {
+		//The shadow console only outputs the SNES PPU's frames, Game Boy games use regular run-ahead
+		UpdateRunAheadShadow(useRunAhead && _settings->GetEmulationConfig().RunAheadSecondInstance && !_settings->CheckFlag(EmulationFlags::GameboyMode));
+		if(_isRunAheadShadowActive) {
+			RunFrameWithRunAheadShadow();
+		} else if(useRunAhead) {
 			RunFrameWithRunAhead();
 		} else {
 			RunFrame();
@@ -167,6 +178,9 @@ void Console::Run()
 
 	_movieManager->Stop();
 
+	_runAheadShadow.reset();
+	_isRunAheadShadowActive = false;
+
 	_emulationThreadId = thread::id();
 
 	PlatformUtilities::RestoreTimerResolution();
@@ -186,13 +200,12 @@ bool Console::ProcessSystemActions()
 
 void Console::RunFrameWithRunAhead()
 {
-	stringstream runAheadState;
 	uint32_t frameCount = _settings->GetEmulationConfig().RunAheadFrames;
 
 	//Run a single frame and save the state (no audio/video)
 	_isRunAheadFrame = true;
 	RunFrame();
-	Serialize(runAheadState, 0);
+	SaveSnapshot(_runAheadState);
 
 	while(frameCount > 1) {
 		//Run extra frames if the requested run ahead frame count is higher than 1
@@ -209,11 +222,56 @@ void Console::RunFrameWithRunAhead()
 	if(!wasReset) {
 		//Load the state we saved earlier
 		_isRunAheadFrame = true;
-		Deserialize(runAheadState, SaveStateManager::FileFormatVersion, false);
+		LoadSnapshot(_runAheadState);
 		_isRunAheadFrame = false;
 	}
 }
 
+void Console::RunFrameWithRunAheadShadow()
+{
+	//Run the real frame on this thread (with audio output), the shadow console runs ahead and outputs the video
+	RunFrame();
+	_rewindManager->ProcessEndOfFrame();
+	ProcessSystemActions();
+
+	_runAheadShadow->RunAhead(_settings->GetEmulationConfig().RunAheadFrames);
+}
+
+void Console::UpdateRunAheadShadow(bool enabled)
+{
+	if(enabled) {
+		if(!_runAheadShadow) {
+			_runAheadShadow.reset(new RunAheadShadow(this));
+			_notificationManager->RegisterNotificationListener(_runAheadShadow);
+		}
+		//Use regular run-ahead if the game could not be loaded on the shadow console
+		_isRunAheadShadowActive = _runAheadShadow->IsLoaded();
+	} else if(_runAheadShadow) {
+		if(_settings->GetEmulationConfig().RunAheadSecondInstance) {
+			//Run-ahead is temporarily disabled (e.g while rewinding), keep the shadow console loaded
+			_runAheadShadow->WaitForFrame();
+		} else {
+			_runAheadShadow.reset();
+		}
+		_isRunAheadShadowActive = false;
+	}
+}
+
+void Console::RunShadowFrames(ConsoleSnapshot &snapshot, uint32_t frameCount)
+{
+	_emulationThreadId = std::this_thread::get_id();
+
+	_isRunAheadFrame = true;
+	LoadSnapshot(snapshot);
+	for(uint32_t i = 0; i < frameCount; i++) {
+		//Only the last frame is rendered
+		_isRunAheadOutputFrame = i == frameCount - 1;
+		RunFrame();
+	}
+	_isRunAheadOutputFrame = false;
+	_isRunAheadFrame = false;
+}
+
 void Console::ProcessEndOfFrame()
 {
 #ifndef LIBRETRO
@@ -459,11 +517,15 @@ bool Console::LoadRom(VirtualFile romFile, VirtualFile patchFile, bool stopRom,
 				
 		UpdateRegion();
 
-		_notificationManager->SendNotification(ConsoleNotificationType::GameLoaded, (void*)forPowerCycle);
+		//Consoles that are hidden from the frontend (e.g the run-ahead shadow console) don't report the game being loaded
+		bool frontendOutput = !_settings->CheckFlag(EmulationFlags::NoFrontendOutput);
+		if(frontendOutput) {
+			_notificationManager->SendNotification(ConsoleNotificationType::GameLoaded, (void*)forPowerCycle);
+		}
 
 		_paused = false;
 
-		if(!forPowerCycle) {
+		if(!forPowerCycle && frontendOutput) {
 			string modelName = _region == ConsoleRegion::Pal ? "PAL" : "NTSC";
 			string messageTitle = MessageManager::Localize("GameLoaded") + " (" + modelName + ")";
 			MessageManager::DisplayMessage(messageTitle, FolderUtilities::GetFilename(GetRomInfo().RomFile.GetFileName(), false));
@@ -475,7 +537,7 @@ bool Console::LoadRom(VirtualFile romFile, VirtualFile patchFile, bool stopRom,
 			#endif
 		}
 		result = true;
-	} else {
+	} else if(!_settings->CheckFlag(EmulationFlags::NoFrontendOutput)) {
 		MessageManager::DisplayMessage("Error", "CouldNotLoadFile", romFile.GetFileName());
 	}
 
@@ -543,6 +605,15 @@ double Console::GetFps()
 	}
 }
 
+void Console::SetPerfCountersEnabled(bool enabled)
+{
+	if(enabled) {
+		_perfCounters.reset(new PerfCounters());
+	} else {
+		_perfCounters.reset();
+	}
+}
+
 double Console::GetFrameDelay()
 {
 	uint32_t emulationSpeed = _settings->GetEmulationSpeed();
@@ -709,9 +780,8 @@ void Console::WaitForLock()
 	}
 }
 
-void Console::Serialize(ostream &out, int compressionLevel)
+void Console::StreamComponents(Serializer &serializer)
 {
-	Serializer serializer(SaveStateManager::FileFormatVersion);
 	bool isGameboyMode = _settings->CheckFlag(EmulationFlags::GameboyMode);
 
 	if(!isGameboyMode) {
@@ -730,33 +800,47 @@ void Console::Serialize(ostream &out, int compressionLevel)
 		serializer.Stream(_cart.get());
 		serializer.Stream(_controlManager.get());
 	}
+}
+
+void Console::Serialize(ostream &out, int compressionLevel)
+{
+	Serializer serializer(SaveStateManager::FileFormatVersion);
+	StreamComponents(serializer);
 	serializer.Save(out, compressionLevel);
 }
 
+uint32_t Console::Serialize(vector<uint8_t> &buffer)
+{
+	Serializer serializer(SaveStateManager::FileFormatVersion, buffer);
+	StreamComponents(serializer);
+	return serializer.GetSize();
+}
+
 void Console::Deserialize(istream &in, uint32_t fileFormatVersion, bool compressed)
 {
 	Serializer serializer(in, fileFormatVersion, compressed);
-	bool isGameboyMode = _settings->CheckFlag(EmulationFlags::GameboyMode);
+	StreamComponents(serializer);
+	_notificationManager->SendNotification(ConsoleNotificationType::StateLoaded);
+}
 
-	if(!isGameboyMode) {
-		serializer.Stream(_cpu.get());
-		serializer.Stream(_memoryManager.get());
-		serializer.Stream(_ppu.get());
-		serializer.Stream(_dmaController.get());
-		serializer.Stream(_internalRegisters.get());
-		serializer.Stream(_cart.get());
-		serializer.Stream(_controlManager.get());
-		serializer.Stream(_spc.get());
-		if(_msu1) {
-			serializer.Stream(_msu1.get());
-		}
-	} else {
-		serializer.Stream(_cart.get());
-		serializer.Stream(_controlManager.get());
-	}
+void Console::Deserialize(const uint8_t* data, uint32_t size, uint32_t fileFormatVersion)
+{
+	Serializer serializer(data, size, fileFormatVersion);
+	StreamComponents(serializer);
 	_notificationManager->SendNotification(ConsoleNotificationType::StateLoaded);
 }
 
+void Console::SaveSnapshot(ConsoleSnapshot &snapshot)
+{
+	snapshot.Size = Serialize(snapshot.Data);
+}
+
+void Console::LoadSnapshot(ConsoleSnapshot &snapshot)
+{
+	Serializer serializer(snapshot.Data.data(), snapshot.Size, SaveStateManager::FileFormatVersion);
+	StreamComponents(serializer);
+}
+
 shared_ptr<SoundMixer> Console::GetSoundMixer()
 {
 	return _soundMixer;
@@ -885,11 +969,6 @@ void Console::StopDebugger()
 	Unlock();
 }
 
-bool Console::IsDebugging()
-{
-	return _debugger != nullptr;
-}
-
 thread::id Console::GetEmulationThreadId()
 {
 	return _emulationThreadId;
@@ -905,6 +984,30 @@ bool Console::IsRunAheadFrame()
 	return _isRunAheadFrame;
 }
 
+bool Console::IsRunAheadOutputFrame()
+{
+	return _isRunAheadOutputFrame;
+}
+
+bool Console::IsRunAheadShadowActive()
+{
+	return _isRunAheadShadowActive;
+}
+
+void Console::RenderNextFrame()
+{
+	_renderNextFrame = true;
+}
+
+bool Console::IsNoVideoFrame()
+{
+	//Called by the PPU once per frame - the pending RenderNextFrame request is only consumed by a frame that is output
+	//(run-ahead frames that are not displayed are not rendered regardless of this value)
+	bool isOutputFrame = (!_isRunAheadFrame || _isRunAheadOutputFrame) && !_isRunAheadShadowActive;
+	bool renderFrame = isOutputFrame && _renderNextFrame.exchange(false);
+	return !renderFrame && _settings->CheckFlag(EmulationFlags::NoVideo);
+}
+
 uint32_t Console::GetFrameCount()
 {
 	shared_ptr<BaseCartridge> cart = _cart;
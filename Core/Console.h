@@ -32,7 +32,16 @@ class MovieManager;
 class SpcHud;
 class FrameLimiter;
 class DebugStats;
+class PerfCounters;
 class Msu1;
+class Serializer;
+class RunAheadShadow;
+
+struct ConsoleSnapshot
+{
+	vector<uint8_t> Data;
+	uint32_t Size = 0;
+};
 
 enum class MemoryOperationType;
 enum class SnesMemoryType;
@@ -89,9 +98,16 @@ private:
 	uint32_t _masterClockRate;
 
 	atomic<bool> _isRunAheadFrame;
+	atomic<bool> _renderNextFrame;
+	bool _isRunAheadOutputFrame = false;
 	bool _frameRunning = false;
+	ConsoleSnapshot _runAheadState;
+
+	shared_ptr<RunAheadShadow> _runAheadShadow;
+	bool _isRunAheadShadowActive = false;
 
 	unique_ptr<DebugStats> _stats;
+	unique_ptr<PerfCounters> _perfCounters;
 	unique_ptr<FrameLimiter> _frameLimiter;
 	Timer _lastFrameTimer;
 	double _frameDelay = 0;
@@ -104,6 +120,10 @@ private:
 	void RunFrame();
 	bool ProcessSystemActions();
 	void RunFrameWithRunAhead();
+	void RunFrameWithRunAheadShadow();
+	void UpdateRunAheadShadow(bool enabled);
+
+	void StreamComponents(Serializer &serializer);
 
 public:
 	Console();
@@ -117,6 +137,9 @@ public:
 	void RunSingleFrame();
 	void Stop(bool sendNotification);
 
+	//Used by run-ahead shadow consoles: loads the snapshot and runs the frames without any output, except for the last frame's PPU output
+	void RunShadowFrames(ConsoleSnapshot &snapshot, uint32_t frameCount);
+
 	void ProcessEndOfFrame();
 
 	void Reset();
@@ -144,6 +167,14 @@ public:
 	void Serialize(ostream &out, int compressionLevel = 1);
 	void Deserialize(istream &in, uint32_t fileFormatVersion, bool compressed = true);
 
+	//Uncompressed state, saved into (and loaded from) a caller-owned buffer that can be reused between calls
+	uint32_t Serialize(vector<uint8_t> &buffer);
+	void Deserialize(const uint8_t* data, uint32_t size, uint32_t fileFormatVersion);
+
+	//In-memory snapshot of the emulation state, restored without notifying listeners (used by run-ahead)
+	void SaveSnapshot(ConsoleSnapshot &snapshot);
+	void LoadSnapshot(ConsoleSnapshot &snapshot);
+
 	shared_ptr<SoundMixer> GetSoundMixer();
 	shared_ptr<VideoRenderer> GetVideoRenderer();
 	shared_ptr<VideoDecoder> GetVideoDecoder();
@@ -169,16 +200,25 @@ public:
 
 	shared_ptr<Debugger> GetDebugger(bool autoStart = true);
 	void StopDebugger();
-	bool IsDebugging();
+	__forceinline bool IsDebugging() { return _debugger != nullptr; }
 
 	thread::id GetEmulationThreadId();
 	
 	bool IsRunning();
 	bool IsRunAheadFrame();
+	bool IsRunAheadOutputFrame();
+	bool IsRunAheadShadowActive();
+
+	//No-video mode (EmulationFlags::NoVideo): frames are not rendered or decoded, unless requested with RenderNextFrame
+	void RenderNextFrame();
+	bool IsNoVideoFrame();
 
 	uint32_t GetFrameCount();	
 	double GetFps();
 
+	void SetPerfCountersEnabled(bool enabled);
+	PerfCounters* GetPerfCounters() { return _perfCounters.get(); }
+
 	void CopyRewindData(shared_ptr<Console> sourceConsole);
 
 	template<CpuType type> __forceinline void ProcessMemoryRead(uint32_t addr, uint8_t value, MemoryOperationType opType)
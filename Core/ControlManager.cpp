@@ -139,14 +139,19 @@ void ControlManager::UpdateControlDevices()
 
 void ControlManager::UpdateInputState()
 {
-	KeyManager::RefreshKeyState();
+	bool useHostInput = KeyManager::IsBoundTo(_console->GetSettings().get());
+	if(useHostInput) {
+		KeyManager::RefreshKeyState();
+	}
 
 	auto lock = _deviceLock.AcquireSafe();
 
 	//string log = "F: " + std::to_string(_console->GetPpu()->GetFrameCount()) + " C:" + std::to_string(_pollCounter) + " ";
 	for(shared_ptr<BaseControlDevice> &device : _controlDevices) {
 		device->ClearState();
-		device->SetStateFromInput();
+		if(useHostInput) {
+			device->SetStateFromInput();
+		}
 
 		for(size_t i = 0; i < _inputProviders.size(); i++) {
 			IInputProvider* provider = _inputProviders[i];
@@ -205,9 +210,18 @@ void ControlManager::Write(uint16_t addr, uint8_t value)
 void ControlManager::Serialize(Serializer &s)
 {
 	InputConfig cfg = _console->GetSettings()->GetInputConfig();
+	ControllerType orgTypes[5] = { cfg.Controllers[0].Type, cfg.Controllers[1].Type, cfg.Controllers[2].Type, cfg.Controllers[3].Type, cfg.Controllers[4].Type };
 	s.Stream(cfg.Controllers[0].Type, cfg.Controllers[1].Type, cfg.Controllers[2].Type, cfg.Controllers[3].Type, cfg.Controllers[4].Type);
 	if(!s.IsSaving()) {
-		_console->GetSettings()->SetInputConfig(cfg);
+		bool controllersChanged = false;
+		for(int i = 0; i < 5; i++) {
+			controllersChanged |= orgTypes[i] != cfg.Controllers[i].Type;
+		}
+
+		//Only recreate the devices when the state uses different controllers (run-ahead loads a state every frame)
+		if(controllersChanged) {
+			_console->GetSettings()->SetInputConfig(cfg);
+		}
 		UpdateControlDevices();
 	}
 
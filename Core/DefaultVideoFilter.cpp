@@ -5,6 +5,7 @@
 #include "Console.h"
 #include "EmuSettings.h"
 #include "SettingTypes.h"
+#include "../Utilities/SimdUtilities.h"
 
 const static double PI = 3.14159265358979323846;
 
@@ -123,38 +124,21 @@ void DefaultVideoFilter::ApplyFilter(uint16_t *ppuOutputBuffer)
 	uint32_t yOffset = overscan.Top * overscanMultiplier * width;
 
 	uint8_t scanlineIntensity = (uint8_t)((1.0 - _console->GetSettings()->GetVideoConfig().ScanlineIntensity) * 255);
-	if(scanlineIntensity < 255) {
-		for(uint32_t i = 0; i < frameInfo.Height; i++) {
-			if(i & 0x01) {
-				for(uint32_t j = 0; j < frameInfo.Width; j++) {
-					*out = ApplyScanlineEffect(GetPixel(ppuOutputBuffer, i * width + j + yOffset + xOffset), scanlineIntensity);
-					out++;
-				}
-			} else {
-				for(uint32_t j = 0; j < frameInfo.Width; j++) {
-					*out = GetPixel(ppuOutputBuffer, i * width + j + yOffset + xOffset);
-					out++;
-				}
-			}
-		}
-	} else {
-		for(uint32_t i = 0; i < frameInfo.Height; i++) {
-			for(uint32_t j = 0; j < frameInfo.Width; j++) {
-				out[i*frameInfo.Width+j] = GetPixel(ppuOutputBuffer, i * width + j + yOffset + xOffset);
-			}
+	bool blendHighRes = _baseFrameInfo.Width == 512 && _videoConfig.BlendHighResolutionModes;
+
+	//Each row is converted, darkened (scanline effect) and blended in a single pass, while it is still in the cache
+	for(uint32_t i = 0; i < frameInfo.Height; i++) {
+		uint32_t* row = out + i * frameInfo.Width;
+		uint8_t rowIntensity = (i & 0x01) ? scanlineIntensity : 255;
+		if(_gbBlendFrames) {
+			DecodeRow<true>(ppuOutputBuffer, i * width + yOffset + xOffset, row, frameInfo.Width, rowIntensity);
+		} else {
+			DecodeRow<false>(ppuOutputBuffer, i * width + yOffset + xOffset, row, frameInfo.Width, rowIntensity);
 		}
-	}
 
-	if(_baseFrameInfo.Width == 512 && _videoConfig.BlendHighResolutionModes) {
-		//Very basic blend effect for high resolution modes
-		for(uint32_t i = 0; i < frameInfo.Height; i+=2) {
-			for(uint32_t j = 0; j < frameInfo.Width; j+=2) {
-				uint32_t &pixel1 = out[i*frameInfo.Width + j];
-				uint32_t &pixel2 = out[i*frameInfo.Width + j + 1];
-				uint32_t &pixel3 = out[(i+1)*frameInfo.Width + j];
-				uint32_t &pixel4 = out[(i+1)*frameInfo.Width + j + 1];
-				pixel1 = pixel2 = pixel3 = pixel4 = BlendPixels(BlendPixels(BlendPixels(pixel1, pixel2), pixel3), pixel4);
-			}
+		if(blendHighRes && (i & 0x01)) {
+			//Very basic blend effect for high resolution modes
+			BlendHighResRows(row - frameInfo.Width, row, frameInfo.Width);
 		}
 	}
 
@@ -163,6 +147,86 @@ void DefaultVideoFilter::ApplyFilter(uint16_t *ppuOutputBuffer)
 	}
 }
 
+#ifdef HAS_SSE2
+static __forceinline __m128i BlendPixels4(__m128i a, __m128i b)
+{
+	//Same as BlendPixels, for 4 pixels
+	__m128i halfDiff = _mm_srli_epi32(_mm_and_si128(_mm_xor_si128(a, b), _mm_set1_epi32(0xfffefefe)), 1);
+	return _mm_add_epi32(halfDiff, _mm_and_si128(a, b));
+}
+
+static __forceinline __m128i ApplyScanlineEffect2(__m128i pixels, __m128i intensity)
+{
+	//Same as ApplyScanlineEffect, for 2 pixels (16-bit channels) - (x + 1 + (x >> 8)) >> 8 == x / 255 for 0 <= x <= 255*255
+	__m128i value = _mm_mullo_epi16(pixels, intensity);
+	return _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(value, _mm_set1_epi16(1)), _mm_srli_epi16(value, 8)), 8);
+}
+#endif
+
+template<bool blendFrames>
+void DefaultVideoFilter::DecodeRow(uint16_t* ppuFrame, uint32_t offset, uint32_t* out, uint32_t width, uint8_t scanlineIntensity)
+{
+	uint32_t x = 0;
+#ifdef HAS_SSE2
+	__m128i zero = _mm_setzero_si128();
+	__m128i intensity = _mm_set1_epi16(scanlineIntensity);
+	__m128i alpha = _mm_set1_epi32(0xFF000000);
+	for(; x + 4 <= width; x += 4) {
+		uint16_t* src = ppuFrame + offset + x;
+		__m128i pixels = _mm_set_epi32(_calculatedPalette[src[3]], _calculatedPalette[src[2]], _calculatedPalette[src[1]], _calculatedPalette[src[0]]);
+		if(blendFrames) {
+			uint16_t* prev = _prevFrame + offset + x;
+			__m128i prevPixels = _mm_set_epi32(_calculatedPalette[prev[3]], _calculatedPalette[prev[2]], _calculatedPalette[prev[1]], _calculatedPalette[prev[0]]);
+			pixels = BlendPixels4(prevPixels, pixels);
+		}
+
+		if(scanlineIntensity < 255) {
+			__m128i lo = ApplyScanlineEffect2(_mm_unpacklo_epi8(pixels, zero), intensity);
+			__m128i hi = ApplyScanlineEffect2(_mm_unpackhi_epi8(pixels, zero), intensity);
+			pixels = _mm_or_si128(_mm_packus_epi16(lo, hi), alpha);
+		}
+
+		_mm_storeu_si128((__m128i*)(out + x), pixels);
+	}
+#endif
+
+	for(; x < width; x++) {
+		uint32_t pixel = GetPixel(ppuFrame, offset + x);
+		out[x] = scanlineIntensity < 255 ? ApplyScanlineEffect(pixel, scanlineIntensity) : pixel;
+	}
+}
+
+void DefaultVideoFilter::BlendHighResRows(uint32_t* row1, uint32_t* row2, uint32_t width)
+{
+	//All 4 pixels of each 2x2 block are replaced by their average
+	uint32_t x = 0;
+#ifdef HAS_SSE2
+	for(; x + 8 <= width; x += 8) {
+		__m128 a1 = _mm_castsi128_ps(_mm_loadu_si128((__m128i*)(row1 + x)));
+		__m128 a2 = _mm_castsi128_ps(_mm_loadu_si128((__m128i*)(row1 + x + 4)));
+		__m128 b1 = _mm_castsi128_ps(_mm_loadu_si128((__m128i*)(row2 + x)));
+		__m128 b2 = _mm_castsi128_ps(_mm_loadu_si128((__m128i*)(row2 + x + 4)));
+
+		__m128i pixel1 = _mm_castps_si128(_mm_shuffle_ps(a1, a2, _MM_SHUFFLE(2, 0, 2, 0)));
+		__m128i pixel2 = _mm_castps_si128(_mm_shuffle_ps(a1, a2, _MM_SHUFFLE(3, 1, 3, 1)));
+		__m128i pixel3 = _mm_castps_si128(_mm_shuffle_ps(b1, b2, _MM_SHUFFLE(2, 0, 2, 0)));
+		__m128i pixel4 = _mm_castps_si128(_mm_shuffle_ps(b1, b2, _MM_SHUFFLE(3, 1, 3, 1)));
+		__m128i result = BlendPixels4(BlendPixels4(BlendPixels4(pixel1, pixel2), pixel3), pixel4);
+
+		__m128i lo = _mm_unpacklo_epi32(result, result);
+		__m128i hi = _mm_unpackhi_epi32(result, result);
+		_mm_storeu_si128((__m128i*)(row1 + x), lo);
+		_mm_storeu_si128((__m128i*)(row1 + x + 4), hi);
+		_mm_storeu_si128((__m128i*)(row2 + x), lo);
+		_mm_storeu_si128((__m128i*)(row2 + x + 4), hi);
+	}
+#endif
+
+	for(; x + 1 < width; x += 2) {
+		row1[x] = row1[x + 1] = row2[x] = row2[x + 1] = BlendPixels(BlendPixels(BlendPixels(row1[x], row1[x + 1]), row2[x]), row2[x + 1]);
+	}
+}
+
 uint32_t DefaultVideoFilter::GetPixel(uint16_t* ppuFrame, uint32_t offset)
 {
 	if(_gbBlendFrames) {
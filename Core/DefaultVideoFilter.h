@@ -24,6 +24,9 @@ private:
 	__forceinline static uint32_t BlendPixels(uint32_t a, uint32_t b);
 	__forceinline uint32_t GetPixel(uint16_t* ppuFrame, uint32_t offset);
 
+	template<bool blendFrames> void DecodeRow(uint16_t* ppuFrame, uint32_t offset, uint32_t* out, uint32_t width, uint8_t scanlineIntensity);
+	void BlendHighResRows(uint32_t* row1, uint32_t* row2, uint32_t width);
+
 protected:
 	void OnBeforeApplyFilter();
 
@@ -0,0 +1,213 @@
+#include "stdafx.h"
+#include "HeadlessConsole.h"
+#include "Console.h"
+#include "EmuSettings.h"
+#include "ControlManager.h"
+#include "VideoRenderer.h"
+#include "SoundMixer.h"
+#include "MovieManager.h"
+#include "SaveStateManager.h"
+#include "SnesController.h"
+#include "NotificationManager.h"
+
+//The control manager is recreated every time a game is loaded (including power cycles and reloads),
+//so the console's input provider must be registered again each time
+class HeadlessNotificationListener : public INotificationListener
+{
+private:
+	Console* _console;
+	IInputProvider* _inputProvider;
+
+public:
+	HeadlessNotificationListener(Console* console, IInputProvider* inputProvider)
+	{
+		_console = console;
+		_inputProvider = inputProvider;
+	}
+
+	void ProcessNotification(ConsoleNotificationType type, void* parameter) override
+	{
+		if(type == ConsoleNotificationType::GameLoaded) {
+			shared_ptr<ControlManager> controlManager = _console->GetControlManager();
+			controlManager->UnregisterInputProvider(_inputProvider);
+			controlManager->RegisterInputProvider(_inputProvider);
+		}
+	}
+};
+
+HeadlessConsole::HeadlessConsole(bool useThread)
+{
+	_stopFlag = false;
+
+	_console.reset(new Console());
+	_console->Initialize();
+
+	_notificationListener.reset(new HeadlessNotificationListener(_console.get(), this));
+	_console->GetNotificationManager()->RegisterNotificationListener(_notificationListener);
+
+	_console->GetVideoRenderer()->RegisterRenderingDevice(this);
+	_console->GetSoundMixer()->RegisterAudioDevice(this);
+
+	AudioConfig audioConfig = _console->GetSettings()->GetAudioConfig();
+	audioConfig.DisableDynamicSampleRate = true;
+	_console->GetSettings()->SetAudioConfig(audioConfig);
+
+	PreferencesConfig preferences = _console->GetSettings()->GetPreferences();
+	preferences.RewindBufferSize = 0;
+	_console->GetSettings()->SetPreferences(preferences);
+
+	if(useThread) {
+		_frameThread.reset(new thread(&HeadlessConsole::FrameThread, this));
+	}
+}
+
+HeadlessConsole::~HeadlessConsole()
+{
+	if(_frameThread) {
+		WaitForFrame();
+		_stopFlag = true;
+		_startSignal.Signal();
+		_frameThread->join();
+	}
+
+	_console->GetMovieManager()->Stop();
+	_notificationListener.reset();
+
+	shared_ptr<ControlManager> controlManager = _console->GetControlManager();
+	if(controlManager) {
+		controlManager->UnregisterInputProvider(this);
+	}
+
+	_console->GetVideoRenderer()->UnregisterRenderingDevice(this);
+	_console->GetSoundMixer()->RegisterAudioDevice(nullptr);
+	_console->Release();
+}
+
+bool HeadlessConsole::LoadRom(VirtualFile romFile, VirtualFile patchFile)
+{
+	WaitForFrame();
+
+	//The input provider is registered by the GameLoaded notification
+	return _console->LoadRom(romFile, patchFile);
+}
+
+void HeadlessConsole::RunFrame()
+{
+	StartFrame();
+	WaitForFrame();
+}
+
+void HeadlessConsole::StartFrame()
+{
+	WaitForFrame();
+
+	_audioBuffer.clear();
+	if(_frameThread) {
+		_framePending = true;
+		_startSignal.Signal();
+	} else {
+		_console->RunSingleFrame();
+	}
+}
+
+void HeadlessConsole::WaitForFrame()
+{
+	if(_framePending) {
+		_frameDone.Wait();
+		_framePending = false;
+	}
+}
+
+void HeadlessConsole::FrameThread()
+{
+	while(true) {
+		_startSignal.Wait();
+		if(_stopFlag) {
+			break;
+		}
+
+		_console->RunSingleFrame();
+		_frameDone.Signal();
+	}
+}
+
+void HeadlessConsole::SetControllerState(uint8_t port, uint32_t buttons)
+{
+	WaitForFrame();
+	if(port < BaseControlDevice::PortCount) {
+		_controllerState[port] = buttons;
+	}
+}
+
+void HeadlessConsole::SetVideoEnabled(bool enabled)
+{
+	WaitForFrame();
+	_console->GetSettings()->SetFlagState(EmulationFlags::NoVideo, !enabled);
+}
+
+void HeadlessConsole::RenderNextFrame()
+{
+	WaitForFrame();
+	_console->RenderNextFrame();
+}
+
+uint32_t* HeadlessConsole::GetFrameBuffer(uint32_t &width, uint32_t &height)
+{
+	WaitForFrame();
+	width = _frameWidth;
+	height = _frameHeight;
+	return _frameBuffer.data();
+}
+
+int16_t* HeadlessConsole::GetAudioBuffer(uint32_t &sampleCount, uint32_t &sampleRate)
+{
+	WaitForFrame();
+	sampleCount = (uint32_t)_audioBuffer.size() / 2;
+	sampleRate = _sampleRate;
+	return _audioBuffer.data();
+}
+
+void HeadlessConsole::SaveState(ostream &stream)
+{
+	WaitForFrame();
+	_console->GetSaveStateManager()->SaveState(stream);
+}
+
+bool HeadlessConsole::LoadState(istream &stream)
+{
+	WaitForFrame();
+	return _console->GetSaveStateManager()->LoadState(stream);
+}
+
+shared_ptr<Console> HeadlessConsole::GetConsole()
+{
+	WaitForFrame();
+	return _console;
+}
+
+bool HeadlessConsole::SetInput(BaseControlDevice* device)
+{
+	if(device->GetControllerType() != ControllerType::SnesController) {
+		return false;
+	}
+
+	uint32_t buttons = _controllerState[device->GetPort()];
+	for(uint8_t i = SnesController::Buttons::A; i <= SnesController::Buttons::Right; i++) {
+		device->SetBitValue(i, (buttons >> i) & 0x01);
+	}
+	return true;
+}
+
+void HeadlessConsole::UpdateFrame(void *frameBuffer, uint32_t width, uint32_t height)
+{
+	_frameBuffer.resize(width * height);
+	memcpy(_frameBuffer.data(), frameBuffer, width * height * sizeof(uint32_t));
+	_frameWidth = width;
+	_frameHeight = height;
+}
+
+void HeadlessConsole::PlayBuffer(int16_t *soundBuffer, uint32_t sampleCount, uint32_t sampleRate, bool isStereo)
+{
+	_audioBuffer.insert(_audioBuffer.end(), soundBuffer, soundBuffer + sampleCount * 2);
+	_sampleRate = sampleRate;
+}
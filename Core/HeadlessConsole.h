@@ -0,0 +1,90 @@
+#pragma once
+#include "stdafx.h"
+#include "IInputProvider.h"
+#include "IRenderingDevice.h"
+#include "IAudioDevice.h"
+#include "INotificationListener.h"
+#include "BaseControlDevice.h"
+#include "../Utilities/VirtualFile.h"
+#include "../Utilities/AutoResetEvent.h"
+
+class Console;
+
+//Emulator instance that is stepped manually, one frame at a time, by its owner
+//Any number of instances can exist in the same process: each one owns its console, only receives
+//the input given to SetControllerState (never the host's keyboard/mouse) and captures its own video/audio output.
+//Frames run on the caller's thread, or on the instance's own thread when it is created with useThread.
+//Different instances can run in parallel on different threads, but a single instance must only be used by one thread at a time.
+//Requires a headless build (LIBRETRO), where frames are decoded synchronously at the end of each frame.
+class HeadlessConsole : public IInputProvider, public IRenderingDevice, public IAudioDevice
+{
+private:
+	shared_ptr<Console> _console;
+	uint32_t _controllerState[BaseControlDevice::PortCount] = {};
+
+	vector<uint32_t> _frameBuffer;
+	uint32_t _frameWidth = 0;
+	uint32_t _frameHeight = 0;
+
+	vector<int16_t> _audioBuffer;
+	uint32_t _sampleRate = 0;
+
+	shared_ptr<INotificationListener> _notificationListener;
+
+	unique_ptr<thread> _frameThread;
+	AutoResetEvent _startSignal;
+	AutoResetEvent _frameDone;
+	atomic<bool> _stopFlag;
+	bool _framePending = false;
+
+	void FrameThread();
+
+public:
+	HeadlessConsole(bool useThread = false);
+	virtual ~HeadlessConsole();
+
+	bool LoadRom(VirtualFile romFile, VirtualFile patchFile = {});
+	void RunFrame();
+
+	//Starts running a frame and returns without waiting for it when the instance has its own thread
+	//All other calls wait for the frame to be done before accessing the console
+	void StartFrame();
+	void WaitForFrame();
+
+	//Buttons use the SnesController::Buttons bit order
+	void SetControllerState(uint8_t port, uint32_t buttons);
+
+	//When disabled, frames are emulated without rendering any pixels or decoding them (the PPU's flags/counters stay accurate)
+	//and GetFrameBuffer keeps returning the last frame that was rendered
+	void SetVideoEnabled(bool enabled);
+	//Renders the next frame even if video is disabled
+	void RenderNextFrame();
+
+	//ARGB output of the last frame
+	uint32_t* GetFrameBuffer(uint32_t &width, uint32_t &height);
+	//Interleaved stereo samples produced by the last call to RunFrame
+	int16_t* GetAudioBuffer(uint32_t &sampleCount, uint32_t &sampleRate);
+
+	void SaveState(ostream &stream);
+	bool LoadState(istream &stream);
+
+	shared_ptr<Console> GetConsole();
+
+	// Inherited via IInputProvider
+	bool SetInput(BaseControlDevice* device) override;
+
+	// Inherited via IRenderingDevice
+	void UpdateFrame(void *frameBuffer, uint32_t width, uint32_t height) override;
+	void Render() override {}
+	void Reset() override {}
+	void SetFullscreenMode(bool fullscreen, void* windowHandle, uint32_t monitorWidth, uint32_t monitorHeight) override {}
+
+	// Inherited via IAudioDevice
+	void PlayBuffer(int16_t *soundBuffer, uint32_t sampleCount, uint32_t sampleRate, bool isStereo) override;
+	void Stop() override {}
+	void Pause() override {}
+	void ProcessEndOfFrame() override {}
+	string GetAvailableDevices() override { return string(); }
+	void SetAudioDevice(string deviceName) override {}
+	AudioStatistics GetStatistics() override { return AudioStatistics(); }
+};
@@ -0,0 +1,59 @@
+#include "stdafx.h"
+#include "HeadlessConsoleTest.h"
+#include "HeadlessConsole.h"
+#include "Console.h"
+#include "BatteryManager.h"
+#include "ControlManager.h"
+#include "SnesController.h"
+#include "../Utilities/VirtualFile.h"
+
+bool HeadlessConsoleTest::IsInputReceived(HeadlessConsole &instance, uint32_t buttons)
+{
+	instance.SetControllerState(0, buttons);
+	instance.RunFrame();
+
+	shared_ptr<BaseControlDevice> device = instance.GetConsole()->GetControlManager()->GetControlDevice(0);
+	if(!device) {
+		return false;
+	}
+	for(uint8_t i = SnesController::Buttons::A; i <= SnesController::Buttons::Right; i++) {
+		if(device->IsPressed(i) != (((buttons >> i) & 0x01) != 0)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+int32_t HeadlessConsoleTest::RunInputTest(VirtualFile &romFile, bool useThread)
+{
+	HeadlessConsole instance(useThread);
+	if(!instance.LoadRom(romFile)) {
+		return -1;
+	}
+	instance.GetConsole()->GetBatteryManager()->SetSaveEnabled(false);
+
+	constexpr uint32_t buttons = (1 << SnesController::Buttons::A) | (1 << SnesController::Buttons::Start);
+	int32_t errorCount = 0;
+	errorCount += IsInputReceived(instance, buttons) ? 0 : 1;
+
+	instance.GetConsole()->PowerCycle();
+	errorCount += IsInputReceived(instance, buttons) ? 0 : 1;
+	errorCount += IsInputReceived(instance, 0) ? 0 : 1;
+
+	instance.GetConsole()->Reset();
+	errorCount += IsInputReceived(instance, buttons) ? 0 : 1;
+	return errorCount;
+}
+
+int32_t HeadlessConsoleTest::Run(VirtualFile romFile)
+{
+	int32_t errorCount = 0;
+	for(bool useThread : { false, true }) {
+		int32_t result = RunInputTest(romFile, useThread);
+		if(result < 0) {
+			return -1;
+		}
+		errorCount += result;
+	}
+	return errorCount;
+}
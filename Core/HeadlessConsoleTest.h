@@ -0,0 +1,18 @@
+#pragma once
+#include "stdafx.h"
+
+class HeadlessConsole;
+class VirtualFile;
+
+//Checks that headless consoles (with and without their own thread) keep receiving the input given to
+//SetControllerState after being power cycled (which recreates the control manager) or reset
+class HeadlessConsoleTest
+{
+private:
+	static bool IsInputReceived(HeadlessConsole &instance, uint32_t buttons);
+	static int32_t RunInputTest(VirtualFile &romFile, bool useThread);
+
+public:
+	//Returns the number of failed checks, or -1 if the rom could not be loaded
+	static int32_t Run(VirtualFile romFile);
+};
@@ -0,0 +1,112 @@
+#include "stdafx.h"
+#include "HeadlessScheduler.h"
+#include "HeadlessConsole.h"
+
+HeadlessScheduler::HeadlessScheduler(uint32_t threadCount)
+{
+	if(threadCount == 0) {
+		threadCount = std::max<uint32_t>(1, std::thread::hardware_concurrency());
+	}
+
+	_threadCount = threadCount;
+	_queues.reset(new WorkQueue[threadCount]);
+	for(uint32_t i = 0; i < threadCount; i++) {
+		_queues[i].Next = 0;
+		_queues[i].End = 0;
+	}
+
+	_pendingWorkers = 0;
+	_stopFlag = false;
+
+	//The calling thread acts as worker #0
+	for(uint32_t i = 1; i < threadCount; i++) {
+		_startSignals.push_back(unique_ptr<AutoResetEvent>(new AutoResetEvent()));
+	}
+	for(uint32_t i = 1; i < threadCount; i++) {
+		_workers.push_back(unique_ptr<std::thread>(new std::thread(&HeadlessScheduler::WorkerThread, this, i)));
+	}
+}
+
+HeadlessScheduler::~HeadlessScheduler()
+{
+	_stopFlag = true;
+	for(unique_ptr<AutoResetEvent> &signal : _startSignals) {
+		signal->Signal();
+	}
+	for(unique_ptr<std::thread> &worker : _workers) {
+		worker->join();
+	}
+}
+
+uint32_t HeadlessScheduler::GetThreadCount()
+{
+	return _threadCount;
+}
+
+void HeadlessScheduler::WorkerThread(uint32_t index)
+{
+	while(true) {
+		_startSignals[index - 1]->Wait();
+		if(_stopFlag) {
+			break;
+		}
+
+		ProcessQueues(index);
+
+		if(--_pendingWorkers == 0) {
+			_batchDone.Signal();
+		}
+	}
+}
+
+void HeadlessScheduler::ProcessQueues(uint32_t index)
+{
+	const vector<HeadlessConsole*> &batch = *_batch;
+
+	//Start with this thread's own slice, then help the others (in order, starting with the next thread's slice)
+	for(uint32_t i = 0; i < _threadCount; i++) {
+		WorkQueue &queue = _queues[(index + i) % _threadCount];
+		while(true) {
+			uint32_t consoleIndex = queue.Next++;
+			if(consoleIndex >= queue.End) {
+				break;
+			}
+			batch[consoleIndex]->RunFrame();
+		}
+	}
+}
+
+void HeadlessScheduler::RunFrame(const vector<HeadlessConsole*> &consoles, vector<HeadlessFrame> &frames)
+{
+	uint32_t consoleCount = (uint32_t)consoles.size();
+	uint32_t workerCount = std::min(_threadCount, consoleCount);
+
+	//Split the batch into one contiguous slice per thread
+	for(uint32_t i = 0; i < _threadCount; i++) {
+		_queues[i].Next = (uint32_t)((uint64_t)consoleCount * i / _threadCount);
+		_queues[i].End = (uint32_t)((uint64_t)consoleCount * (i + 1) / _threadCount);
+	}
+
+	_batch = &consoles;
+	if(workerCount > 1) {
+		_pendingWorkers = workerCount - 1;
+		for(uint32_t i = 1; i < workerCount; i++) {
+			_startSignals[i - 1]->Signal();
+		}
+	}
+
+	ProcessQueues(0);
+
+	if(workerCount > 1) {
+		_batchDone.Wait();
+	}
+	_batch = nullptr;
+
+	frames.resize(consoleCount);
+	for(uint32_t i = 0; i < consoleCount; i++) {
+		HeadlessFrame &frame = frames[i];
+		frame.Console = consoles[i];
+		frame.FrameBuffer = consoles[i]->GetFrameBuffer(frame.Width, frame.Height);
+		frame.AudioBuffer = consoles[i]->GetAudioBuffer(frame.SampleCount, frame.SampleRate);
+	}
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include "stdafx.h"
+#include "../Utilities/AutoResetEvent.h"
+
+class HeadlessConsole;
+
+struct HeadlessFrame
+{
+	HeadlessConsole* Console;
+
+	uint32_t* FrameBuffer;
+	uint32_t Width;
+	uint32_t Height;
+
+	int16_t* AudioBuffer;
+	uint32_t SampleCount;
+	uint32_t SampleRate;
+};
+
+//Runs a batch of headless consoles for a frame each, spread over a pool of worker threads.
+//Each thread starts on its own slice of the batch (so a console keeps running on the same thread
+//from one batch to the next) and then steals consoles from the other slices once its own is done.
+class HeadlessScheduler
+{
+private:
+	struct alignas(64) WorkQueue
+	{
+		atomic<uint32_t> Next;
+		uint32_t End;
+	};
+
+	vector<unique_ptr<std::thread>> _workers;
+	vector<unique_ptr<AutoResetEvent>> _startSignals;
+	unique_ptr<WorkQueue[]> _queues;
+	uint32_t _threadCount = 0;
+
+	const vector<HeadlessConsole*>* _batch = nullptr;
+	atomic<uint32_t> _pendingWorkers;
+	AutoResetEvent _batchDone;
+	atomic<bool> _stopFlag;
+
+	void WorkerThread(uint32_t index);
+	void ProcessQueues(uint32_t index);
+
+public:
+	//threadCount includes the calling thread, 0 uses one thread per host core
+	HeadlessScheduler(uint32_t threadCount = 0);
+	~HeadlessScheduler();
+
+	uint32_t GetThreadCount();
+
+	//Runs a frame on every console (each console must appear only once) and returns their output.
+	//Buffers stay valid until the console runs its next frame.
+	void RunFrame(const vector<HeadlessConsole*> &consoles, vector<HeadlessFrame> &frames);
+};
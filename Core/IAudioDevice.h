@@ -4,9 +4,17 @@
 
 struct AudioStatistics
 {
+	static constexpr int JitterBucketCount = 6;
+
 	double AverageLatency = 0;
 	uint32_t BufferUnderrunEventCount = 0;
 	uint32_t BufferSize = 0;
+
+	//Number of samples (per channel) that were buffered at the end of the last frame
+	uint32_t CurrentLatency = 0;
+
+	//Number of frames for each range of frame-to-frame change in buffered audio: <1ms, <2ms, <4ms, <8ms, <16ms, 16ms+
+	uint32_t LatencyJitter[JitterBucketCount] = {};
 };
 
 class IAudioDevice
@@ -20,6 +20,10 @@ public:
 	virtual void PeekBlock(uint32_t addr, uint8_t *output) = 0;
 	virtual void Write(uint32_t addr, uint8_t value) = 0;
 
+	//Pointer to the 4 KB page's data, for handlers whose reads (or writes) can be done directly, without side effects
+	virtual uint8_t* GetReadPointer() { return nullptr; }
+	virtual uint8_t* GetWritePointer() { return nullptr; }
+
 	__forceinline SnesMemoryType GetMemoryType()
 	{
 		return _memoryType;
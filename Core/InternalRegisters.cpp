@@ -40,6 +40,37 @@ void InternalRegisters::Reset()
 	_irqLevel = false;
 	_needIrq = false;
 	_irqFlag = false;
+	UpdateIrqCheckWindow();
+}
+
+void InternalRegisters::UpdateIrqCheckWindow()
+{
+	//The IRQ signal's level only depends on the current scanline and the H clock, so the H clocks where it
+	//can change are computed here (when the registers are written to, or when a new scanline starts),
+	//instead of being re-evaluated on every PPU cycle
+	uint16_t scanline = _ppu->GetRealScanline();
+	bool vMatch = !_state.EnableVerticalIrq || scanline == _state.VerticalTimer;
+
+	if(_state.EnableHorizontalIrq) {
+		bool hMatch = vMatch && _state.HorizontalTimer <= 339 && (_ppu->GetLastScanline() != scanline || _state.HorizontalTimer < 339);
+		if(_irqLevel) {
+			//The signal goes back to low after the matching dot
+			_irqCheckStart = 0;
+			_irqCheckEnd = 0xFFFF;
+		} else if(hMatch) {
+			//Dots 323 and 327 are 6 master clocks long, the matching dot is within these 8 master clocks
+			_irqCheckStart = _state.HorizontalTimer * 4;
+			_irqCheckEnd = _irqCheckStart + 8;
+		} else {
+			_irqCheckStart = 0xFFFF;
+			_irqCheckEnd = 0xFFFF;
+		}
+	} else {
+		//Without the H timer, the signal stays the same for the entire scanline
+		bool irqLevel = _state.EnableVerticalIrq && vMatch;
+		_irqCheckStart = irqLevel == _irqLevel ? 0xFFFF : 0;
+		_irqCheckEnd = 0xFFFF;
+	}
 }
 
 void InternalRegisters::ProcessAutoJoypadRead()
@@ -175,6 +206,7 @@ void InternalRegisters::Write(uint16_t addr, uint8_t value)
 			
 			SetNmiFlag(_nmiFlag);
 			SetIrqFlag(_irqFlag);
+			UpdateIrqCheckWindow();
 			break;
 
 		case 0x4201:
@@ -195,16 +227,19 @@ void InternalRegisters::Write(uint16_t addr, uint8_t value)
 
 		case 0x4207: 
 			_state.HorizontalTimer = (_state.HorizontalTimer & 0x100) | value; 
+			UpdateIrqCheckWindow();
 			ProcessIrqCounters();
 			break;
 
 		case 0x4208: 
 			_state.HorizontalTimer = (_state.HorizontalTimer & 0xFF) | ((value & 0x01) << 8); 
+			UpdateIrqCheckWindow();
 			ProcessIrqCounters();
 			break;
 
 		case 0x4209: 
 			_state.VerticalTimer = (_state.VerticalTimer & 0x100) | value; 
+			UpdateIrqCheckWindow();
 
 			//Calling this here fixes flashing issue in "Shin Nihon Pro Wrestling Kounin - '95 Tokyo Dome Battle 7"
 			//The write to change from scanline 16 to 17 occurs between both ProcessIrqCounter calls, which causes the IRQ
@@ -214,6 +249,7 @@ void InternalRegisters::Write(uint16_t addr, uint8_t value)
 
 		case 0x420A: 
 			_state.VerticalTimer = (_state.VerticalTimer & 0xFF) | ((value & 0x01) << 8);
+			UpdateIrqCheckWindow();
 			ProcessIrqCounters();
 			break;
 
@@ -244,4 +280,8 @@ void InternalRegisters::Serialize(Serializer &s)
 	);
 
 	s.Stream(&_aluMulDiv);
+
+	if(!s.IsSaving()) {
+		UpdateIrqCheckWindow();
+	}
 }
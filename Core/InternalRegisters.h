@@ -24,6 +24,10 @@ private:
 	bool _irqLevel = false;
 	uint8_t _needIrq = 0;
 	bool _irqFlag = false;
+
+	//Range of H clocks where the IRQ counters need to be processed on every PPU cycle (the IRQ signal can't change outside of it)
+	uint16_t _irqCheckStart = 0xFFFF;
+	uint16_t _irqCheckEnd = 0xFFFF;
 	
 	void SetIrqFlag(bool irqFlag);
 
@@ -37,6 +41,14 @@ public:
 
 	__forceinline void ProcessIrqCounters();
 
+	void UpdateIrqCheckWindow();
+
+	//True when processing the IRQ counters between these H clock values can't change the IRQ signal
+	__forceinline bool IsIrqCounterIdle(uint16_t startHClock, uint16_t endHClock)
+	{
+		return _needIrq == 0 && (endHClock < _irqCheckStart || startHClock >= _irqCheckEnd);
+	}
+
 	uint8_t GetIoPortOutput();
 	void SetNmiFlag(bool nmiFlag);
 
@@ -76,6 +88,10 @@ void InternalRegisters::ProcessIrqCounters()
 		//Trigger IRQ signal 16 master clocks later
 		_needIrq = 4;
 	}
-	_irqLevel = irqLevel;
+
+	if(_irqLevel != irqLevel) {
+		_irqLevel = irqLevel;
+		UpdateIrqCheckWindow();
+	}
 	_cpu->SetNmiFlag(_state.EnableNmi & _nmiFlag);
 }
\ No newline at end of file
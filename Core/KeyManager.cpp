@@ -30,9 +30,16 @@ void KeyManager::SetSettings(EmuSettings *settings)
 	_settings = settings;
 }
 
+bool KeyManager::IsBoundTo(EmuSettings* settings)
+{
+	//Host keyboard/mouse input only drives the console whose settings were given to SetSettings
+	//Any other console in the process (e.g headless instances) only receives input from its input providers
+	return _settings != nullptr && _settings == settings;
+}
+
 bool KeyManager::IsKeyPressed(uint32_t keyCode)
 {
-	if(_keyManager != nullptr) {
+	if(_keyManager != nullptr && _settings != nullptr) {
 		return _settings->IsInputEnabled() && _keyManager->IsKeyPressed(keyCode);
 	}
 	return false;
@@ -40,7 +47,7 @@ bool KeyManager::IsKeyPressed(uint32_t keyCode)
 
 bool KeyManager::IsMouseButtonPressed(MouseButton button)
 {
-	if(_keyManager != nullptr) {
+	if(_keyManager != nullptr && _settings != nullptr) {
 		return _settings->IsInputEnabled() && _keyManager->IsMouseButtonPressed(button);
 	}
 	return false;
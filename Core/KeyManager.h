@@ -17,6 +17,7 @@ private:
 public:
 	static void RegisterKeyManager(IKeyManager* keyManager);
 	static void SetSettings(EmuSettings* settings);
+	static bool IsBoundTo(EmuSettings* settings);
 
 	static void RefreshKeyState();
 	static bool IsKeyPressed(uint32_t keyCode);
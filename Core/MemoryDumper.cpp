@@ -35,6 +35,14 @@ void MemoryDumper::SetMemoryState(SnesMemoryType type, uint8_t *buffer, uint32_t
 		return;
 	}
 
+	if(type == SnesMemoryType::SpriteRam) {
+		//Pause emulation so the PPU can't rebuild its sprite lines from a partially written OAM
+		DebugBreakHelper helper(_debugger);
+		memcpy(_ppu->GetSpriteRam(), buffer, length);
+		_ppu->InvalidateSpriteLines();
+		return;
+	}
+
 	uint8_t* dst = GetMemoryBuffer(type);
 	if(dst) {
 		memcpy(dst, buffer, length);
@@ -212,7 +220,13 @@ void MemoryDumper::SetMemoryValue(SnesMemoryType memoryType, uint32_t address, u
 
 		default:
 			uint8_t* src = GetMemoryBuffer(memoryType);
-			if(src) {
+			if(memoryType == SnesMemoryType::SpriteRam) {
+				//The sprite line masks belong to the emulation thread, pause it while they are invalidated
+				DebugBreakHelper helper(_debugger);
+				src[address] = value;
+				invalidateCache();
+				_ppu->InvalidateSpriteLines();
+			} else if(src) {
 				src[address] = value;
 				invalidateCache();
 			}
@@ -128,42 +128,56 @@ void MemoryManager::GenerateMasterClockTable()
 
 void MemoryManager::IncMasterClock4()
 {
-	Exec();
-	Exec();
+	if(!FastForward(4)) {
+		Exec();
+		Exec();
+	}
 }
 
 void MemoryManager::IncMasterClock6()
 {
-	Exec();
-	Exec();
-	Exec();
+	if(!FastForward(6)) {
+		Exec();
+		Exec();
+		Exec();
+	}
 }
 
 void MemoryManager::IncMasterClock8()
 {
-	Exec();
-	Exec();
-	Exec();
-	Exec();
+	if(!FastForward(8)) {
+		Exec();
+		Exec();
+		Exec();
+		Exec();
+	}
 }
 
 void MemoryManager::IncMasterClock40()
 {
-	Exec(); Exec(); Exec(); Exec(); Exec();
-	Exec(); Exec(); Exec(); Exec(); Exec();
-	Exec(); Exec(); Exec(); Exec(); Exec();
-	Exec(); Exec(); Exec(); Exec(); Exec();
+	if(!FastForward(40)) {
+		Exec(); Exec(); Exec(); Exec(); Exec();
+		Exec(); Exec(); Exec(); Exec(); Exec();
+		Exec(); Exec(); Exec(); Exec(); Exec();
+		Exec(); Exec(); Exec(); Exec(); Exec();
+	}
 }
 
 void MemoryManager::IncMasterClockStartup()
 {
-	for(int i = 0; i < 182 / 2; i++) {
-		Exec();
+	if(!FastForward(182)) {
+		for(int i = 0; i < 182 / 2; i++) {
+			Exec();
+		}
 	}
 }
 
 void MemoryManager::IncrementMasterClockValue(uint16_t cyclesToRun)
 {
+	if(FastForward(cyclesToRun)) {
+		return;
+	}
+
 	switch(cyclesToRun) {
 		case 12: Exec();
 		case 10: Exec();
@@ -174,6 +188,30 @@ void MemoryManager::IncrementMasterClockValue(uint16_t cyclesToRun)
 	}
 }
 
+bool MemoryManager::FastForward(uint16_t cyclesToRun)
+{
+	//Running Exec() for each 2 master clocks is only needed when something can happen in-between:
+	//an event (HDMA, DRAM refresh, end of scanline), a change in the H/V IRQ signal, or a debugger that needs to see every PPU cycle.
+	//Otherwise, the clock is moved forward in a single step. Coprocessors catch up to the master clock
+	//when they run, so syncing them once at the end gives the same result.
+	uint16_t hClock = _hClock + cyclesToRun;
+	if(hClock >= _nextEventClock || !_regs->IsIrqCounterIdle(_hClock, hClock) || _console->IsDebugging()) {
+		return false;
+	}
+
+	bool irqCounterStep = (hClock >> 2) != (_hClock >> 2);
+	_masterClock += cyclesToRun;
+	_hClock = hClock;
+
+	if(irqCounterStep) {
+		//Keeps the CPU's NMI flag in sync, like the last step would have
+		_regs->ProcessIrqCounters();
+	}
+
+	_cart->SyncCoprocessors();
+	return true;
+}
+
 void MemoryManager::Exec()
 {
 	_masterClock += 2;
@@ -201,9 +239,7 @@ void MemoryManager::ProcessEvent()
 			break;
 
 		case SnesEventType::DramRefresh:
-			IncMasterClock40();
-			_cpu->IncreaseCycleCount<5>();
-
+			//Select the next event first, to allow the refresh's 40 cycles to be skipped in a single step
 			if(_ppu->GetScanline() < _ppu->GetVblankStart()) {
 				_nextEvent = SnesEventType::HdmaStart;
 				_nextEventClock = 276 * 4;
@@ -211,6 +247,9 @@ void MemoryManager::ProcessEvent()
 				_nextEvent = SnesEventType::EndOfScanline;
 				_nextEventClock = 1360;
 			}
+
+			IncMasterClock40();
+			_cpu->IncreaseCycleCount<5>();
 			break;
 
 		case SnesEventType::HdmaStart:
@@ -222,6 +261,7 @@ void MemoryManager::ProcessEvent()
 		case SnesEventType::EndOfScanline:
 			if(_ppu->ProcessEndOfScanline(_hClock)) {
 				_hClock = 0;
+				_regs->UpdateIrqCheckWindow();
 
 				if(_ppu->GetScanline() == 0) {
 					_nextEvent = SnesEventType::HdmaInit;
@@ -243,10 +283,15 @@ uint8_t MemoryManager::Read(uint32_t addr, MemoryOperationType type)
 	IncrementMasterClockValue(_cpuSpeed - 4);
 
 	uint8_t value;
-	IMemoryHandler *handler = _mappings.GetHandler(addr);
-	if(handler) {
+	uint8_t* page = _mappings.GetReadPointer(addr);
+	if(page) {
+		//ROM/RAM that can be read directly, without calling its handler
+		value = page[addr & 0xFFF];
+		_busAAddress = addr;
+		_openBus = value;
+	} else if(IMemoryHandler *handler = _mappings.GetHandler(addr)) {
 		value = handler->Read(addr);
-		_memTypeBusA = handler->GetMemoryType();
+		_busAAddress = addr;
 		_openBus = value;
 	} else {
 		//open bus
@@ -266,8 +311,13 @@ uint8_t MemoryManager::ReadDma(uint32_t addr, bool forBusA)
 	IncMasterClock4();
 
 	uint8_t value;
-	IMemoryHandler* handler = _mappings.GetHandler(addr);
-	if(handler) {
+	uint8_t* page = _mappings.GetReadPointer(addr);
+	IMemoryHandler* handler;
+	if(page) {
+		value = page[addr & 0xFFF];
+		_busAAddress = addr;
+		_openBus = value;
+	} else if((handler = _mappings.GetHandler(addr)) != nullptr) {
 		if(forBusA && handler == _registerHandlerB.get() && (addr & 0xFF00) == 0x2100) {
 			//Trying to read from bus B using bus A returns open bus
 			value = _openBus;
@@ -282,7 +332,7 @@ uint8_t MemoryManager::ReadDma(uint32_t addr, bool forBusA)
 		} else {
 			value = handler->Read(addr);
 			if(handler != _registerHandlerB.get()) {
-				_memTypeBusA = handler->GetMemoryType();
+				_busAAddress = addr;
 			}
 		}
 		_openBus = value;
@@ -316,10 +366,13 @@ void MemoryManager::Write(uint32_t addr, uint8_t value, MemoryOperationType type
 	IncrementMasterClockValue(_cpuSpeed);
 
 	_console->ProcessMemoryWrite<CpuType::Cpu>(addr, value, type);
-	IMemoryHandler* handler = _mappings.GetHandler(addr);
-	if(handler) {
+	uint8_t* page = _mappings.GetWritePointer(addr);
+	if(page) {
+		page[addr & 0xFFF] = value;
+		_busAAddress = addr;
+	} else if(IMemoryHandler* handler = _mappings.GetHandler(addr)) {
 		handler->Write(addr, value);
-		_memTypeBusA = handler->GetMemoryType();
+		_busAAddress = addr;
 	} else {
 		LogDebug("[Debug] Write - missing handler: $" + HexUtilities::ToHex(addr) + " = " + HexUtilities::ToHex(value));
 	}
@@ -331,8 +384,12 @@ void MemoryManager::WriteDma(uint32_t addr, uint8_t value, bool forBusA)
 	IncMasterClock4();
 	_console->ProcessMemoryWrite<CpuType::Cpu>(addr, value, MemoryOperationType::DmaWrite);
 
-	IMemoryHandler* handler = _mappings.GetHandler(addr);
-	if(handler) {
+	uint8_t* page = _mappings.GetWritePointer(addr);
+	IMemoryHandler* handler;
+	if(page) {
+		page[addr & 0xFFF] = value;
+		_busAAddress = addr;
+	} else if((handler = _mappings.GetHandler(addr)) != nullptr) {
 		if(forBusA && handler == _registerHandlerB.get() && (addr & 0xFF00) == 0x2100) {
 			//Trying to write to bus B using bus A does nothing
 		} else if(handler == _registerHandlerA.get()) {
@@ -345,7 +402,7 @@ void MemoryManager::WriteDma(uint32_t addr, uint8_t value, bool forBusA)
 		} else {
 			handler->Write(addr, value);
 			if(handler != _registerHandlerB.get()) {
-				_memTypeBusA = handler->GetMemoryType();
+				_busAAddress = addr;
 			}
 		}
 	} else {
@@ -395,7 +452,9 @@ void MemoryManager::SetCpuSpeed(uint8_t speed)
 
 SnesMemoryType MemoryManager::GetMemoryTypeBusA()
 {
-	return _memTypeBusA;
+	//Resolved on demand (only needed by the SA-1), to keep this out of the read/write fast path
+	IMemoryHandler* handler = _mappings.GetHandler(_busAAddress);
+	return handler ? handler->GetMemoryType() : SnesMemoryType::PrgRom;
 }
 
 bool MemoryManager::IsRegister(uint32_t cpuAddress)
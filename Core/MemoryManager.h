@@ -47,7 +47,7 @@ private:
 	uint16_t _nextEventClock = 0;
 	uint16_t _dramRefreshPosition = 0;
 	SnesEventType _nextEvent = SnesEventType::DramRefresh;
-	SnesMemoryType _memTypeBusA = SnesMemoryType::PrgRom;
+	uint32_t _busAAddress = 0;
 
 	uint8_t _cpuSpeed = 8;
 	uint8_t _openBus = 0;
@@ -57,6 +57,7 @@ private:
 	uint8_t _masterClockTable[0x800];
 
 	void Exec();
+	__forceinline bool FastForward(uint16_t cyclesToRun);
 
 	void ProcessEvent();
 
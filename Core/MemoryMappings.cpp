@@ -14,7 +14,7 @@ void MemoryMappings::RegisterHandler(uint8_t startBank, uint8_t endBank, uint16_
 	for(uint32_t i = startBank; i <= endBank; i++) {
 		pageNumber += pageIncrement;
 		for(uint32_t j = startPage; j <= endPage; j += 0x1000) {
-			_handlers[(i << 4) | (j >> 12)] = handlers[pageNumber].get();
+			SetHandler((i << 4) | (j >> 12), handlers[pageNumber].get());
 			//MessageManager::Log("Map [$" + HexUtilities::ToHex(i) + ":" + HexUtilities::ToHex(j)[1] + "xxx] to page number " + HexUtilities::ToHex(pageNumber));
 			pageNumber++;
 			if(pageNumber >= handlers.size()) {
@@ -36,11 +36,18 @@ void MemoryMappings::RegisterHandler(uint8_t startBank, uint8_t endBank, uint16_
 			throw std::runtime_error("handler already set");
 			}*/
 
-			_handlers[(bank << 4) | (addr >> 12)] = handler;
+			SetHandler((bank << 4) | (addr >> 12), handler);
 		}
 	}
 }
 
+void MemoryMappings::SetHandler(uint32_t page, IMemoryHandler* handler)
+{
+	_handlers[page] = handler;
+	_reads[page] = handler ? handler->GetReadPointer() : nullptr;
+	_writes[page] = handler ? handler->GetWritePointer() : nullptr;
+}
+
 IMemoryHandler* MemoryMappings::GetHandler(uint32_t addr)
 {
 	return _handlers[addr >> 12];
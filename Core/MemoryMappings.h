@@ -9,11 +9,28 @@ class MemoryMappings
 private:
 	IMemoryHandler* _handlers[0x100 * 0x10] = {};
 
+	//Direct pointers to the pages that can be accessed without going through their handler (e.g ROM/RAM)
+	uint8_t* _reads[0x100 * 0x10] = {};
+	uint8_t* _writes[0x100 * 0x10] = {};
+
+	void SetHandler(uint32_t page, IMemoryHandler* handler);
+
 public:
 	void RegisterHandler(uint8_t startBank, uint8_t endBank, uint16_t startPage, uint16_t endPage, vector<unique_ptr<IMemoryHandler>>& handlers, uint16_t pageIncrement = 0, uint16_t startPageNumber = 0);
 	void RegisterHandler(uint8_t startBank, uint8_t endBank, uint16_t startAddr, uint16_t endAddr, IMemoryHandler* handler);
 
 	IMemoryHandler* GetHandler(uint32_t addr);
+
+	__forceinline uint8_t* GetReadPointer(uint32_t addr)
+	{
+		return _reads[addr >> 12];
+	}
+
+	__forceinline uint8_t* GetWritePointer(uint32_t addr)
+	{
+		return _writes[addr >> 12];
+	}
+
 	AddressInfo GetAbsoluteAddress(uint32_t addr);
 	int GetRelativeAddress(AddressInfo& absAddress, uint8_t startBank = 0);
 
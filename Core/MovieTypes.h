@@ -32,10 +32,11 @@ const vector<string> ControllerTypeNames = {
 	"SnesMouseButtonsOnly"
 };
 
+//Must match the order of the RamState enum
 const vector<string> RamStateNames = {
+	"Random",
 	"AllZeros",
-	"AllOnes",
-	"Random"
+	"AllOnes"
 };
 
 namespace MovieKeys
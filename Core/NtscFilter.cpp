@@ -3,13 +3,15 @@
 #include "EmuSettings.h"
 #include "SettingTypes.h"
 #include "Console.h"
+#include "VideoFilterThreadPool.h"
 
-NtscFilter::NtscFilter(shared_ptr<Console> console) : BaseVideoFilter(console)
+NtscFilter::NtscFilter(shared_ptr<Console> console, VideoFilterThreadPool* threadPool) : BaseVideoFilter(console)
 {
+	_threadPool = threadPool;
 	memset(&_ntscData, 0, sizeof(_ntscData));
 	_ntscSetup = { };
 	snes_ntsc_init(&_ntscData, &_ntscSetup);
-	_ntscBuffer = new uint32_t[SNES_NTSC_OUT_WIDTH(256) * 480];
+	_ntscBuffer = new uint32_t[SNES_NTSC_OUT_WIDTH(256) * 239];
 }
 
 FrameInfo NtscFilter::GetFrameInfo()
@@ -48,38 +50,64 @@ void NtscFilter::OnBeforeApplyFilter()
 }
 
 void NtscFilter::ApplyFilter(uint16_t *ppuOutputBuffer)
+{
+	FrameInfo frameInfo = GetFrameInfo();
+	VideoConfig cfg = _console->GetSettings()->GetVideoConfig();
+
+	//Each row of the NTSC output is displayed twice (the 2nd copy gets the scanline effect), so only half of the rows are generated
+	uint32_t rowCount = frameInfo.Height / 2;
+	VideoFilterThreadPool::RunStripes(_threadPool, rowCount, 0, [=](const VideoFilterStripe &stripe) {
+		ApplyFilter(ppuOutputBuffer, stripe.FirstRow, stripe.LastRow, cfg.ScanlineIntensity, cfg.NtscForceLowRes);
+	});
+}
+
+void NtscFilter::ApplyFilter(uint16_t *ppuOutputBuffer, uint32_t firstRow, uint32_t lastRow, double scanlineIntensity, bool forceLowRes)
 {
 	FrameInfo frameInfo = GetFrameInfo();
 	OverscanDimensions overscan = GetOverscan();
-	
+
 	bool useHighResOutput = _baseFrameInfo.Width == 512;
 	uint32_t baseWidth = SNES_NTSC_OUT_WIDTH(256);
 	uint32_t xOffset = overscan.Left * 2;
-	uint32_t yOffset = overscan.Top * 2 * baseWidth;
+	int burstPhase = IsOddFrame() ? 0 : 1;
 
-	if(useHighResOutput) {
-		snes_ntsc_blit_hires(&_ntscData, ppuOutputBuffer, 512, IsOddFrame() ? 0 : 1, 512, _baseFrameInfo.Height, _ntscBuffer, SNES_NTSC_OUT_WIDTH(256) * 4);
-	} else {
-		snes_ntsc_blit(&_ntscData, ppuOutputBuffer, 256, IsOddFrame() ? 0 : 1, 256, _baseFrameInfo.Height, _ntscBuffer, SNES_NTSC_OUT_WIDTH(256) * 8);
-	}
-	VideoConfig cfg = _console->GetSettings()->GetVideoConfig();
+	//Row N of the NTSC buffer is generated from row N of the 256x239 picture (or row N*2 of the 512x478 picture)
+	uint32_t srcFirst = overscan.Top + firstRow;
+	uint32_t srcLast = overscan.Top + lastRow;
 
-	if(cfg.ScanlineIntensity == 0) {
-		for(uint32_t i = 0; i < frameInfo.Height; i+=2) {
-			memcpy(GetOutputBuffer()+i*frameInfo.Width, _ntscBuffer + yOffset + xOffset + i*baseWidth, frameInfo.Width * sizeof(uint32_t));
-			memcpy(GetOutputBuffer()+(i+1)*frameInfo.Width, _ntscBuffer + yOffset + xOffset + i*baseWidth, frameInfo.Width * sizeof(uint32_t));
+	if(!useHighResOutput) {
+		snes_ntsc_blit(&_ntscData, ppuOutputBuffer + srcFirst * 256, 256, (burstPhase + srcFirst) % snes_ntsc_burst_count, 256, srcLast - srcFirst, _ntscBuffer + srcFirst * baseWidth, baseWidth * 4);
+	} else if(forceLowRes) {
+		//Blend each pair of pixels and use the 256-pixel blitter (about half the work of the high resolution blitter)
+		uint16_t lowResRow[256];
+		for(uint32_t y = srcFirst; y < srcLast; y++) {
+			uint16_t* src = ppuOutputBuffer + y * 1024;
+			for(int x = 0; x < 256; x++) {
+				uint16_t a = src[x << 1];
+				uint16_t b = src[(x << 1) + 1];
+				lowResRow[x] = (a & b) + (((a ^ b) & 0x7BDE) >> 1);
+			}
+			snes_ntsc_blit(&_ntscData, lowResRow, 256, (burstPhase + y) % snes_ntsc_burst_count, 256, 1, _ntscBuffer + y * baseWidth, baseWidth * 4);
 		}
 	} else {
-		uint8_t intensity = (uint8_t)((1.0 - cfg.ScanlineIntensity) * 255);
-		for(uint32_t i = 0; i < frameInfo.Height; i++) {
-			if(i & 0x01) {
-				uint32_t *in = _ntscBuffer + yOffset + xOffset + (i - 1) * baseWidth;
-				uint32_t *out = GetOutputBuffer() + i * frameInfo.Width;
-				for(uint32_t j = 0; j < frameInfo.Width; j++) {
-					out[j] = ApplyScanlineEffect(in[j], intensity);
-				}
-			} else {
-				memcpy(GetOutputBuffer()+i*frameInfo.Width, _ntscBuffer + yOffset + xOffset + i*baseWidth, frameInfo.Width * sizeof(uint32_t));
+		//The burst phase changes on every row of the 512x478 picture, including the rows that are skipped
+		for(uint32_t y = srcFirst; y < srcLast; y++) {
+			snes_ntsc_blit_hires(&_ntscData, ppuOutputBuffer + y * 1024, 512, (burstPhase + y * 2) % snes_ntsc_burst_count, 512, 1, _ntscBuffer + y * baseWidth, baseWidth * 4);
+		}
+	}
+
+	uint32_t* outputBuffer = GetOutputBuffer();
+	uint8_t intensity = (uint8_t)((1.0 - scanlineIntensity) * 255);
+	for(uint32_t i = firstRow; i < lastRow; i++) {
+		uint32_t *in = _ntscBuffer + (overscan.Top + i) * baseWidth + xOffset;
+		uint32_t *out = outputBuffer + i * 2 * frameInfo.Width;
+		memcpy(out, in, frameInfo.Width * sizeof(uint32_t));
+		out += frameInfo.Width;
+		if(scanlineIntensity == 0) {
+			memcpy(out, in, frameInfo.Width * sizeof(uint32_t));
+		} else {
+			for(uint32_t j = 0; j < frameInfo.Width; j++) {
+				out[j] = ApplyScanlineEffect(in[j], intensity);
 			}
 		}
 	}
@@ -4,6 +4,7 @@
 #include "../Utilities/snes_ntsc.h"
 
 class Console;
+class VideoFilterThreadPool;
 
 class NtscFilter : public BaseVideoFilter
 {
@@ -11,12 +12,15 @@ private:
 	snes_ntsc_setup_t _ntscSetup;
 	snes_ntsc_t _ntscData;
 	uint32_t* _ntscBuffer;
+	VideoFilterThreadPool* _threadPool;
+
+	void ApplyFilter(uint16_t *ppuOutputBuffer, uint32_t firstRow, uint32_t lastRow, double scanlineIntensity, bool forceLowRes);
 
 protected:
 	void OnBeforeApplyFilter();
 
 public:
-	NtscFilter(shared_ptr<Console> console);
+	NtscFilter(shared_ptr<Console> console, VideoFilterThreadPool* threadPool = nullptr);
 	virtual ~NtscFilter();
 
 	virtual void ApplyFilter(uint16_t *ppuOutputBuffer);
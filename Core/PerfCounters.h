@@ -0,0 +1,86 @@
+#pragma once
+#include "stdafx.h"
+#include <chrono>
+
+enum class PerfCounterType
+{
+	Ppu = 0,
+	Spc,
+	VideoDecoder,
+	SoundMixer,
+	Count
+};
+
+class PerfCounters
+{
+private:
+	uint64_t _elapsedNs[(int)PerfCounterType::Count] = {};
+	uint64_t _clockOverheadNs = 0;
+
+public:
+	PerfCounters()
+	{
+		//Measure the average cost of reading the clock - an empty scope measures about this much time,
+		//which is removed from each measurement (counters for very frequent scopes, e.g the SPC's catch-up, would be inflated otherwise)
+		constexpr int sampleCount = 1000;
+		std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+		std::chrono::high_resolution_clock::time_point end = start;
+		for(int i = 0; i < sampleCount; i++) {
+			end = std::chrono::high_resolution_clock::now();
+		}
+		_clockOverheadNs = (uint64_t)std::chrono::nanoseconds(end - start).count() / sampleCount;
+	}
+
+	void Add(PerfCounterType type, uint64_t elapsedNs)
+	{
+		_elapsedNs[(int)type] += elapsedNs > _clockOverheadNs ? elapsedNs - _clockOverheadNs : 0;
+	}
+
+	uint64_t GetElapsedNs(PerfCounterType type)
+	{
+		return _elapsedNs[(int)type];
+	}
+
+	void Reset()
+	{
+		memset(_elapsedNs, 0, sizeof(_elapsedNs));
+	}
+
+	static const char* GetName(PerfCounterType type)
+	{
+		switch(type) {
+			case PerfCounterType::Ppu: return "PPU";
+			case PerfCounterType::Spc: return "SPC";
+			case PerfCounterType::VideoDecoder: return "Video";
+			case PerfCounterType::SoundMixer: return "Audio";
+			default: return "";
+		}
+	}
+};
+
+//Adds the time spent in the current scope to the counters (when enabled)
+class PerfCounterScope
+{
+private:
+	PerfCounters* _counters;
+	PerfCounterType _type;
+	std::chrono::high_resolution_clock::time_point _start;
+
+public:
+	PerfCounterScope(PerfCounters* counters, PerfCounterType type)
+	{
+		_counters = counters;
+		_type = type;
+		if(_counters) {
+			_start = std::chrono::high_resolution_clock::now();
+		}
+	}
+
+	~PerfCounterScope()
+	{
+		if(_counters) {
+			std::chrono::nanoseconds elapsed = std::chrono::high_resolution_clock::now() - _start;
+			_counters->Add(_type, (uint64_t)elapsed.count());
+		}
+	}
+};
@@ -1,4 +1,5 @@
 #include "stdafx.h"
+#include <array>
 #include "Ppu.h"
 #include "Console.h"
 #include "MemoryManager.h"
@@ -14,8 +15,11 @@
 #include "MessageManager.h"
 #include "EventType.h"
 #include "RewindManager.h"
+#include "PerfCounters.h"
+#include "PpuRenderThread.h"
 #include "../Utilities/HexUtilities.h"
 #include "../Utilities/Serializer.h"
+#include "../Utilities/SimdUtilities.h"
 
 static constexpr uint8_t _oamSizes[8][2][2] = {
 	{ { 1, 1 }, { 2, 2 } }, //8x8 + 16x16
@@ -28,6 +32,17 @@ static constexpr uint8_t _oamSizes[8][2][2] = {
 	{ { 2, 4 }, { 4, 4 } }  //16x32 + 32x32
 };
 
+//Converts a byte of bitplane data to 8 bytes (byte N contains bit N of the bitplane's byte)
+static const std::array<uint64_t, 256> _chrDecodeTable = []() {
+	std::array<uint64_t, 256> table = {};
+	for(int i = 0; i < 256; i++) {
+		for(int bit = 0; bit < 8; bit++) {
+			table[i] |= (uint64_t)((i >> bit) & 0x01) << (bit * 8);
+		}
+	}
+	return table;
+}();
+
 Ppu::Ppu(Console* console)
 {
 	_console = console;
@@ -40,9 +55,22 @@ Ppu::Ppu(Console* console)
 	memset(_outputBuffers[1], 0, 512 * 478 * sizeof(uint16_t));
 }
 
+Ppu::Ppu(Ppu* mainPpu)
+{
+	_console = mainPpu->_console;
+	_settings = mainPpu->_settings;
+	_vram = mainPpu->_vram;
+	_isRenderThreadPpu = true;
+}
+
 Ppu::~Ppu()
 {
-	delete[] _vram;
+	//Stop the render thread before the video ram/output buffers it uses are deleted
+	_renderThread.reset();
+
+	if(!_isRenderThreadPpu) {
+		delete[] _vram;
+	}
 	delete[] _outputBuffers[0];
 	delete[] _outputBuffers[1];
 }
@@ -50,6 +78,7 @@ Ppu::~Ppu()
 void Ppu::PowerOn()
 {
 	_skipRender = false;
+	_noVideoFrame = false;
 	_regs = _console->GetInternalRegisters().get();
 	_settings = _console->GetSettings().get();
 	_spc = _console->GetSpc().get();
@@ -67,6 +96,8 @@ void Ppu::PowerOn()
 	_settings->InitializeRam(_vram, Ppu::VideoRamSize);
 	_settings->InitializeRam(_cgram, Ppu::CgRamSize);
 	_settings->InitializeRam(_oamRam, Ppu::SpriteRamSize);
+	_dirtySpriteLines[0] = ~0ULL;
+	_dirtySpriteLines[1] = ~0ULL;
 
 	memset(_spriteIndexes, 0xFF, sizeof(_spriteIndexes));
 	
@@ -476,10 +507,22 @@ bool Ppu::ProcessEndOfScanline(uint16_t hClock)
 				_frameSkipTimer.GetElapsedMS() < 10
 			);
 			
-			if(_console->IsRunAheadFrame()) {
+			if((_console->IsRunAheadFrame() && !_console->IsRunAheadOutputFrame()) || _console->IsRunAheadShadowActive()) {
+				_skipRender = true;
+			}
+
+			//No-video mode: only the pixel rendering is skipped, fetches, sprite evaluation and range/time over flags still run
+			_noVideoFrame = _console->IsNoVideoFrame();
+			if(_noVideoFrame) {
 				_skipRender = true;
 			}
 
+			//Not used while debugging - the debugger's tools can read the PPU's state and buffers at any time
+			bool useRenderThread = _settings->GetVideoConfig().UsePpuRenderThread && !_console->IsDebugging();
+			if(useRenderThread != (_renderThread != nullptr)) {
+				_renderThread.reset(useRenderThread ? new PpuRenderThread(this) : nullptr);
+			}
+
 			//Ensure the SPC is re-enabled for the next frame
 			_spc->SetSpcState(true);
 		}
@@ -568,27 +611,144 @@ void Ppu::EvaluateNextLineSprites()
 	if(_spriteEvalStart == 0) {
 		_spriteCount = 0;
 		_oamEvaluationIndex = _state.EnableOamPriority ? ((_internalOamAddress & 0x1FC) >> 2) : 0;
+
+		//Until a sprite's position is read, the range check uses the last sprite that was loaded (by the previous scanline's sprite fetching)
+		_evalSpriteInRange = _currentSprite.IsVisible(_scanline, _state.ObjInterlace);
 	}
 
 	if(_state.ForcedVblank) {
 		return;
 	}
 
-	for(int i = _spriteEvalStart; i <= _spriteEvalEnd; i++) {
-		if(!(i & 0x01)) {
-			//First cycle, read X & Y and high oam byte
-			FetchSpritePosition(_oamEvaluationIndex << 2);
-		} else {
-			//Second cycle: Check if sprite is in range, if so, keep its index
-			if(_currentSprite.IsVisible(_scanline, _state.ObjInterlace)) {
+	UpdateSpriteLines();
+	uint64_t* lineMask = _spriteLineMasks[_scanline];
+
+	//Each sprite takes 2 cycles to evaluate: its position is read on the first (even) cycle and the range check is done on the second one
+	uint16_t evalCount = ((_spriteEvalEnd + 1) >> 1) - (_spriteEvalStart >> 1);
+	if(_spriteEvalStart & 0x01) {
+		//The sprite's position was read during a previous call (before a register write), use the result from that point
+		if(_evalSpriteInRange) {
+			if(_spriteCount < 32) {
+				_spriteIndexes[_spriteCount] = _oamEvaluationIndex;
+				_spriteCount++;
+			} else {
+				_rangeOver = true;
+			}
+		}
+		_oamEvaluationIndex = (_oamEvaluationIndex + 1) & 0x7F;
+		evalCount--;
+	}
+
+	//Only look at the sprites that are in range on this scanline, in OAM order (starting from _oamEvaluationIndex)
+	while(evalCount > 0) {
+		uint8_t block = _oamEvaluationIndex >> 6;
+		uint8_t offset = _oamEvaluationIndex & 0x3F;
+		uint8_t count = (uint8_t)std::min<uint16_t>(evalCount, 64 - offset);
+
+		uint64_t inRange = lineMask[block] >> offset;
+		if(count < 64) {
+			inRange &= (1ULL << count) - 1;
+		}
+
+		for(uint8_t i = 0; inRange; i++, inRange >>= 1) {
+			if(inRange & 0x01) {
 				if(_spriteCount < 32) {
-					_spriteIndexes[_spriteCount] = _oamEvaluationIndex;
+					_spriteIndexes[_spriteCount] = _oamEvaluationIndex + i;
 					_spriteCount++;
 				} else {
 					_rangeOver = true;
+					break;
+				}
+			}
+		}
+
+		_oamEvaluationIndex = (_oamEvaluationIndex + count) & 0x7F;
+		evalCount -= count;
+	}
+
+	//Keep the range check result for the last sprite whose position was read (the check is done on the next odd cycle)
+	if(!(_spriteEvalEnd & 0x01)) {
+		_evalSpriteInRange = (lineMask[_oamEvaluationIndex >> 6] >> (_oamEvaluationIndex & 0x3F)) & 0x01;
+	} else if(_spriteEvalEnd > _spriteEvalStart) {
+		uint8_t lastIndex = (_oamEvaluationIndex - 1) & 0x7F;
+		_evalSpriteInRange = (lineMask[lastIndex >> 6] >> (lastIndex & 0x3F)) & 0x01;
+	}
+}
+
+void Ppu::InvalidateSpriteLines(uint16_t oamAddress)
+{
+	if(oamAddress < 512) {
+		//Only the X/Y bytes affect the scanlines a sprite is in range on
+		if(!(oamAddress & 0x02)) {
+			uint8_t spriteIndex = oamAddress >> 2;
+			_dirtySpriteLines[spriteIndex >> 6] |= 1ULL << (spriteIndex & 0x3F);
+		}
+	} else {
+		//High table byte (X sign bit and size bit for 4 sprites)
+		uint8_t spriteIndex = (oamAddress & 0x1F) << 2;
+		_dirtySpriteLines[spriteIndex >> 6] |= 0x0FULL << (spriteIndex & 0x3F);
+	}
+}
+
+void Ppu::UpdateSpriteLines()
+{
+	if(_spriteLinesOamMode != _state.OamMode || _spriteLinesObjInterlace != _state.ObjInterlace) {
+		//Sprite sizes changed, every sprite needs to be updated
+		_spriteLinesOamMode = _state.OamMode;
+		_spriteLinesObjInterlace = _state.ObjInterlace;
+		_dirtySpriteLines[0] = ~0ULL;
+		_dirtySpriteLines[1] = ~0ULL;
+	}
+
+	if(!(_dirtySpriteLines[0] | _dirtySpriteLines[1])) {
+		return;
+	}
+
+	bool fullUpdate = (_dirtySpriteLines[0] & _dirtySpriteLines[1]) == ~0ULL;
+	if(fullUpdate) {
+		memset(_spriteLineMasks, 0, sizeof(_spriteLineMasks));
+	}
+
+	for(int block = 0; block < 2; block++) {
+		uint64_t dirty = _dirtySpriteLines[block];
+		_dirtySpriteLines[block] = 0;
+
+		for(int i = 0; dirty; i++, dirty >>= 1) {
+			if(!(dirty & 0x01)) {
+				continue;
+			}
+
+			uint64_t spriteMask = 1ULL << i;
+			if(!fullUpdate) {
+				for(int y = 0; y < 256; y++) {
+					_spriteLineMasks[y][block] &= ~spriteMask;
+				}
+			}
+
+			//Same logic as FetchSpritePosition + SpriteInfo::IsVisible
+			uint16_t oamAddress = ((block << 6) | i) << 2;
+			uint8_t highTableValue = _oamRam[0x200 | (oamAddress >> 4)] >> ((oamAddress >> 1) & 0x06);
+			uint8_t largeSprite = (highTableValue & 0x02) >> 1;
+			int16_t x = (int16_t)((((highTableValue & 0x01) << 8) | _oamRam[oamAddress]) << 7) >> 7;
+			uint8_t y = _oamRam[oamAddress + 1];
+			uint8_t width = _oamSizes[_state.OamMode][largeSprite][0] << 3;
+			uint8_t height = _oamSizes[_state.OamMode][largeSprite][1] << 3;
+
+			if(x != -256 && (x + width <= 0 || x > 255)) {
+				//Sprite is never in range (sprites at X=-256 are)
+				continue;
+			}
+
+			uint16_t endY = y + (_state.ObjInterlace ? (height >> 1) : height);
+			uint8_t endY_8 = endY & 0xFF;
+			for(uint16_t line = y; line < endY && line < 256; line++) {
+				_spriteLineMasks[line][block] |= spriteMask;
+			}
+			if(endY_8 < y) {
+				for(uint16_t line = 0; line < endY_8; line++) {
+					_spriteLineMasks[line][block] |= spriteMask;
 				}
 			}
-			_oamEvaluationIndex = (_oamEvaluationIndex + 1) & 0x7F;
 		}
 	}
 }
@@ -725,15 +885,16 @@ void Ppu::FetchSpriteTile(bool secondCycle)
 
 	if(!secondCycle) {
 		_currentSprite.FetchAddress = (_currentSprite.FetchAddress + 8) & 0x7FFF;
-	} else {
+	} else if(!_skipRender) {
 		int16_t xPos = _currentSprite.DrawX;
+		uint64_t pixelRow = GetTilePixelRow<4>(_currentSprite.ChrData);
 		for(int x = 0; x < 8; x++) {
 			if(xPos + x < 0 || xPos + x > 255) {
 				continue;
 			}
 
 			uint8_t xOffset = _currentSprite.HorizontalMirror ? ((7 - x) & 0x07) : x;
-			uint8_t color = GetTilePixelColor<4>(_currentSprite.ChrData, 7 - xOffset);
+			uint8_t color = (uint8_t)(pixelRow >> ((7 - xOffset) << 3));
 
 			if(color != 0) {
 				_spriteColorsCopy[xPos + x] = color;
@@ -826,6 +987,7 @@ void Ppu::RenderMode7()
 
 void Ppu::RenderScanline()
 {
+	PerfCounterScope perfScope(_console->GetPerfCounters(), PerfCounterType::Ppu);
 	int32_t hPos = GetCycle();
 
 	if(hPos <= 255 || _spriteEvalEnd < 255) {
@@ -849,27 +1011,21 @@ void Ppu::RenderScanline()
 	if(!_skipRender && _drawStartX <= 255 && hPos > 22 && _scanline > 0) {
 		_drawEndX = std::min(hPos - 22, 255);
 
-		if(_state.ForcedVblank) {
-			//Forced blank, output black
-			memset(_mainScreenBuffer + _drawStartX, 0, (_drawEndX - _drawStartX + 1) * 2);
-			memset(_subScreenBuffer + _drawStartX, 0, (_drawEndX - _drawStartX + 1) * 2);
-		} else {
-			switch(_state.BgMode) {
-				case 0: RenderMode0(); break;
-				case 1: RenderMode1(); break;
-				case 2: RenderMode2(); break;
-				case 3: RenderMode3(); break;
-				case 4: RenderMode4(); break;
-				case 5: RenderMode5(); break;
-				case 6: RenderMode6(); break;
-				case 7: RenderMode7(); break;
-			}
-			RenderBgColor();
+		if(_drawStartX == 0 && _state.BgMode == 7 && !_state.ForcedVblank && (IsRenderRequired(0) || (_state.ExtBgEnabled && IsRenderRequired(1)))) {
+			//Keep the same scroll offsets for the entire scanline
+			_state.Mode7.HScrollLatch = _state.Mode7.HScroll;
+			_state.Mode7.VScrollLatch = _state.Mode7.VScroll;
 		}
 
-		ApplyColorMath();
-		ApplyBrightness<true>();
-		ApplyHiResMode();
+		if(_useHighResOutput) {
+			_interlacedFrame |= _state.ScreenInterlace;
+		}
+
+		if(_renderThread) {
+			_renderThread->AddJob();
+		} else {
+			RenderScanlineSegment();
+		}
 
 		_drawStartX = _drawEndX + 1;
 	}
@@ -885,6 +1041,32 @@ void Ppu::RenderScanline()
 	}
 }
 
+void Ppu::RenderScanlineSegment()
+{
+	//Draws the current scanline between _drawStartX and _drawEndX (only reads the state, can run on the render thread)
+	if(_state.ForcedVblank) {
+		//Forced blank, output black
+		memset(_mainScreenBuffer + _drawStartX, 0, (_drawEndX - _drawStartX + 1) * 2);
+		memset(_subScreenBuffer + _drawStartX, 0, (_drawEndX - _drawStartX + 1) * 2);
+	} else {
+		switch(_state.BgMode) {
+			case 0: RenderMode0(); break;
+			case 1: RenderMode1(); break;
+			case 2: RenderMode2(); break;
+			case 3: RenderMode3(); break;
+			case 4: RenderMode4(); break;
+			case 5: RenderMode5(); break;
+			case 6: RenderMode6(); break;
+			case 7: RenderMode7(); break;
+		}
+		RenderBgColor();
+	}
+
+	ApplyColorMath();
+	ApplyBrightness<true>();
+	ApplyHiResMode();
+}
+
 void Ppu::RenderBgColor()
 {
 	uint8_t pixelFlags = (_state.ColorMathEnabled & 0x20) ? PixelFlags::AllowColorMath : 0;
@@ -917,16 +1099,21 @@ void Ppu::RenderSprites(const uint8_t priority[4])
 		subWindowCount = (uint8_t)_state.Window[0].ActiveLayers[Ppu::SpriteLayerIndex] + (uint8_t)_state.Window[1].ActiveLayers[Ppu::SpriteLayerIndex];
 	}
 
+	uint8_t windowMask[256];
+	ProcessMaskWindowSpan<Ppu::SpriteLayerIndex>(std::max(mainWindowCount, subWindowCount), windowMask);
+	uint8_t mainWindowEnabled = mainWindowCount ? 0xFF : 0;
+	uint8_t subWindowEnabled = subWindowCount ? 0xFF : 0;
+
 	for(int x = _drawStartX; x <= _drawEndX; x++) {
 		if(_spritePriority[x] <= 3) {
 			uint8_t spritePrio = priority[_spritePriority[x]];
-			if(drawMain && ((_mainScreenFlags[x] & 0x0F) < spritePrio) && !ProcessMaskWindow<Ppu::SpriteLayerIndex>(mainWindowCount, x)) {
+			if(drawMain && ((_mainScreenFlags[x] & 0x0F) < spritePrio) && !(windowMask[x] & mainWindowEnabled)) {
 				uint16_t paletteRamOffset = 128 + (_spritePalette[x] << 4) + _spriteColors[x];
 				_mainScreenBuffer[x] = _cgram[paletteRamOffset];
 				_mainScreenFlags[x] = spritePrio | (((_state.ColorMathEnabled & 0x10) && _spritePalette[x] > 3) ? PixelFlags::AllowColorMath : 0);
 			}
 
-			if(drawSub && (_subScreenPriority[x] < spritePrio) && !ProcessMaskWindow<Ppu::SpriteLayerIndex>(subWindowCount, x)) {
+			if(drawSub && (_subScreenPriority[x] < spritePrio) && !(windowMask[x] & subWindowEnabled)) {
 				uint16_t paletteRamOffset = 128 + (_spritePalette[x] << 4) + _spriteColors[x];
 				_subScreenBuffer[x] = _cgram[paletteRamOffset];
 				_subScreenPriority[x] = spritePrio;
@@ -944,6 +1131,12 @@ void Ppu::RenderTilemap()
 	uint8_t mainWindowCount = _state.WindowMaskMain[layerIndex] ? (uint8_t)_state.Window[0].ActiveLayers[layerIndex] + (uint8_t)_state.Window[1].ActiveLayers[layerIndex] : 0;
 	uint8_t subWindowCount = _state.WindowMaskSub[layerIndex] ? (uint8_t)_state.Window[0].ActiveLayers[layerIndex] + (uint8_t)_state.Window[1].ActiveLayers[layerIndex] : 0;
 
+	//Main & sub screens use the same windows, the mask is only applied to the screens that have masking enabled
+	uint8_t windowMask[256];
+	ProcessMaskWindowSpan<layerIndex>(std::max(mainWindowCount, subWindowCount), windowMask);
+	uint8_t mainWindowEnabled = mainWindowCount ? 0xFF : 0;
+	uint8_t subWindowEnabled = subWindowCount ? 0xFF : 0;
+
 	uint16_t hScrollOriginal = _state.Layers[layerIndex].HScroll;
 	uint16_t hScroll = hiResMode ? (hScrollOriginal << 1) : hScrollOriginal;
 
@@ -956,6 +1149,10 @@ void Ppu::RenderTilemap()
 	uint8_t hiresSubColor;
 	uint8_t pixelFlags = (((_state.ColorMathEnabled >> layerIndex) & 0x01) ? PixelFlags::AllowColorMath : 0);
 
+	//The current tile's row of pixels is only decoded once, when the loop reaches a new tile
+	uint16_t pixelRowKey = 0xFFFF;
+	uint64_t pixelRow = 0;
+
 	for(int x = _drawStartX; x <= _drawEndX; x++) {
 		if(hiResMode) {
 			lookupIndex = (x + (hScrollOriginal & 0x07)) >> 2;
@@ -966,22 +1163,27 @@ void Ppu::RenderTilemap()
 		}
 
 		uint16_t tilemapData = tileData[lookupIndex].TilemapData;
-		uint16_t* chrData = tileData[lookupIndex].ChrData;
 		bool hMirror = (tilemapData & 0x4000) != 0;
 
+		uint16_t tileKey = hiResMode ? ((lookupIndex << 2) | chrDataOffset) : lookupIndex;
+		if(tileKey != pixelRowKey) {
+			pixelRowKey = tileKey;
+			pixelRow = GetTilePixelRow<bpp>(tileData[lookupIndex].ChrData + (hiResMode ? chrDataOffset : 0));
+		}
+
 		uint8_t color;
 		if(hiResMode) {
 			uint8_t xOffset = ((x << 1) + 1 + hScroll) & 0x07;
 			uint8_t shift = hMirror ? xOffset : (7 - xOffset);
-			color = GetTilePixelColor<bpp>(chrData + chrDataOffset, shift);
+			color = (uint8_t)(pixelRow >> (shift << 3));
 			
 			xOffset = ((x << 1) + hScroll) & 0x07;
 			shift = hMirror ? xOffset : (7 - xOffset);
-			hiresSubColor = GetTilePixelColor<bpp>(chrData + chrDataOffset, shift);
+			hiresSubColor = (uint8_t)(pixelRow >> (shift << 3));
 		} else {
 			uint8_t xOffset = (x + hScroll) & 0x07;
 			uint8_t shift = hMirror ? xOffset : (7 - xOffset);
-			color = GetTilePixelColor<bpp>(chrData, shift);
+			color = (uint8_t)(pixelRow >> (shift << 3));
 		}
 
 		uint8_t paletteIndex = (tilemapData >> 10) & 0x07;
@@ -1008,16 +1210,16 @@ void Ppu::RenderTilemap()
 
 		if(color > 0) {
 			uint16_t rgbColor = GetRgbColor<bpp, directColorMode, basePaletteOffset>(paletteIndex, color);
-			if(drawMain && (_mainScreenFlags[x] & 0x0F) < priority && !ProcessMaskWindow<layerIndex>(mainWindowCount, x)) {
+			if(drawMain && (_mainScreenFlags[x] & 0x0F) < priority && !(windowMask[x] & mainWindowEnabled)) {
 				DrawMainPixel(x, rgbColor, priority | pixelFlags);
 			}
-			if(!hiResMode && drawSub && _subScreenPriority[x] < priority && !ProcessMaskWindow<layerIndex>(subWindowCount, x)) {
+			if(!hiResMode && drawSub && _subScreenPriority[x] < priority && !(windowMask[x] & subWindowEnabled)) {
 				DrawSubPixel(x, rgbColor, priority);
 			}
 		}
 
 		if(hiResMode) {
-			if(hiresSubColor > 0 && drawSub && _subScreenPriority[x] < priority && !ProcessMaskWindow<layerIndex>(subWindowCount, x)) {
+			if(hiresSubColor > 0 && drawSub && _subScreenPriority[x] < priority && !(windowMask[x] & subWindowEnabled)) {
 				uint16_t hiresSubRgbColor = GetRgbColor<bpp, directColorMode, basePaletteOffset>(paletteIndex, hiresSubColor);
 				DrawSubPixel(x, hiresSubRgbColor, priority);
 			}
@@ -1038,7 +1240,8 @@ uint16_t Ppu::GetRgbColor(uint8_t paletteIndex, uint8_t colorIndex)
 		//Ignore palette bits for 256-color layers
 		return _cgram[basePaletteOffset + colorIndex];
 	} else {
-		return _cgram[basePaletteOffset + paletteIndex * (1 << bpp) + colorIndex];
+		//Mosaic can reuse a color from a layer with more colors (when the BG mode changes mid-scanline), keep the index within palette ram
+		return _cgram[(basePaletteOffset + paletteIndex * (1 << bpp) + colorIndex) & 0xFF];
 	}
 }
 
@@ -1055,30 +1258,18 @@ bool Ppu::IsRenderRequired(uint8_t layerIndex)
 }
 
 template<uint8_t bpp>
-uint8_t Ppu::GetTilePixelColor(const uint16_t chrData[4], const uint8_t shift)
-{
-	uint8_t color;
-	if(bpp == 2) {
-		color = (chrData[0] >> shift) & 0x01;
-		color |= (chrData[0] >> (7 + shift)) & 0x02;
-	} else if(bpp == 4) {
-		color = (chrData[0] >> shift) & 0x01;
-		color |= (chrData[0] >> (7 + shift)) & 0x02;
-		color |= ((chrData[1] >> shift) & 0x01) << 2;
-		color |= ((chrData[1] >> (7 + shift)) & 0x02) << 2;
-	} else if(bpp == 8) {
-		color = (chrData[0] >> shift) & 0x01;
-		color |= (chrData[0] >> (7 + shift)) & 0x02;
-		color |= ((chrData[1] >> shift) & 0x01) << 2;
-		color |= ((chrData[1] >> (7 + shift)) & 0x02) << 2;
-		color |= ((chrData[2] >> shift) & 0x01) << 4;
-		color |= ((chrData[2] >> (7 + shift)) & 0x02) << 4;
-		color |= ((chrData[3] >> shift) & 0x01) << 6;
-		color |= ((chrData[3] >> (7 + shift)) & 0x02) << 6;
-	} else {
-		throw std::runtime_error("unsupported bpp");
+uint64_t Ppu::GetTilePixelRow(const uint16_t chrData[4])
+{
+	//Returns the color index of each of the tile row's 8 pixels, one per byte (byte N matches bit N of the bitplanes)
+	uint64_t row = _chrDecodeTable[chrData[0] & 0xFF] | (_chrDecodeTable[chrData[0] >> 8] << 1);
+	if(bpp >= 4) {
+		row |= (_chrDecodeTable[chrData[1] & 0xFF] << 2) | (_chrDecodeTable[chrData[1] >> 8] << 3);
 	}
-	return color;
+	if(bpp == 8) {
+		row |= (_chrDecodeTable[chrData[2] & 0xFF] << 4) | (_chrDecodeTable[chrData[2] >> 8] << 5);
+		row |= (_chrDecodeTable[chrData[3] & 0xFF] << 6) | (_chrDecodeTable[chrData[3] >> 8] << 7);
+	}
+	return row;
 }
 
 template<uint8_t layerIndex, uint8_t normalPriority, uint8_t highPriority, bool applyMosaic, bool directColorMode>
@@ -1086,18 +1277,18 @@ void Ppu::RenderTilemapMode7()
 {
 	uint8_t mainWindowCount = _state.WindowMaskMain[layerIndex] ? (uint8_t)_state.Window[0].ActiveLayers[layerIndex] + (uint8_t)_state.Window[1].ActiveLayers[layerIndex] : 0;
 	uint8_t subWindowCount = _state.WindowMaskSub[layerIndex] ? (uint8_t)_state.Window[0].ActiveLayers[layerIndex] + (uint8_t)_state.Window[1].ActiveLayers[layerIndex] : 0;
+
+	//Main & sub screens use the same windows, the mask is only applied to the screens that have masking enabled
+	uint8_t windowMask[256];
+	ProcessMaskWindowSpan<layerIndex>(std::max(mainWindowCount, subWindowCount), windowMask);
+	uint8_t mainWindowEnabled = mainWindowCount ? 0xFF : 0;
+	uint8_t subWindowEnabled = subWindowCount ? 0xFF : 0;
 	
 	bool drawMain = (bool)(((_state.MainScreenLayers & _configVisibleLayers) >> layerIndex) & 0x01);
 	bool drawSub = (bool)(((_state.SubScreenLayers & _configVisibleLayers) >> layerIndex) & 0x01);
 
 	auto clip = [](int32_t val) { return (val & 0x2000) ? (val | ~0x3ff) : (val & 0x3ff); };
 
-	if(_drawStartX == 0) {
-		//Keep the same scroll offsets for the entire scanline
-		_state.Mode7.HScrollLatch = _state.Mode7.HScroll;
-		_state.Mode7.VScrollLatch = _state.Mode7.VScroll;
-	}
-
 	int32_t hScroll = ((int32_t)_state.Mode7.HScrollLatch << 19) >> 19;
 	int32_t vScroll = ((int32_t)_state.Mode7.VScrollLatch << 19) >> 19;
 	int32_t centerX = ((int32_t)_state.Mode7.CenterX << 19) >> 19;
@@ -1139,39 +1330,83 @@ void Ppu::RenderTilemapMode7()
 	
 	uint8_t pixelFlags = ((_state.ColorMathEnabled >> layerIndex) & 0x01) ? PixelFlags::AllowColorMath : 0;
 
-	for(int x = _drawStartX; x <= _drawEndX; x++) {
+	//Transform the coordinates and fetch the color of every pixel first (8 pixels at a time when possible),
+	//and then draw them (mosaic, priority and windows are processed in the same order as before)
+	constexpr uint16_t outsideMap = 0x100;
+	uint16_t colors[256];
+	bool largeMap = _state.Mode7.LargeMap;
+	bool fillWithTile0 = _state.Mode7.FillWithTile0;
+
+	auto fetchColor = [this, fillWithTile0](int32_t tileAddr, int32_t pixelOffset, bool isOutsideMap) -> uint16_t {
+		uint8_t tileIndex = 0;
+		if(!isOutsideMap) {
+			tileIndex = (uint8_t)_vram[tileAddr];
+		} else if(!fillWithTile0) {
+			//Draw nothing for this pixel, we're outside the map
+			return outsideMap;
+		}
+		return _vram[(tileIndex << 6) + pixelOffset] >> 8;
+	};
+
+	int x = _drawStartX;
+#ifdef HAS_SSE2
+	__m128i xSteps = _mm_set_epi32(xStep * 3, xStep * 2, xStep, 0);
+	__m128i ySteps = _mm_set_epi32(yStep * 3, yStep * 2, yStep, 0);
+	__m128i coordMask = _mm_set1_epi32(largeMap ? -1 : 0x3FF);
+	__m128i outsideMask = _mm_set1_epi32(largeMap ? ~0x3FF : 0);
+	__m128i tileMask = _mm_set1_epi32(~0x07);
+	__m128i offsetMask = _mm_set1_epi32(0x07);
+
+	alignas(16) int32_t tileAddr[8];
+	alignas(16) int32_t pixelOffset[8];
+	alignas(16) int32_t isOutsideMap[8];
+	for(; x + 7 <= _drawEndX; x += 8) {
+		for(int i = 0; i < 8; i += 4) {
+			__m128i xOffset = _mm_and_si128(_mm_srai_epi32(_mm_add_epi32(_mm_set1_epi32(xValue), xSteps), 8), coordMask);
+			__m128i yOffset = _mm_and_si128(_mm_srai_epi32(_mm_add_epi32(_mm_set1_epi32(yValue), ySteps), 8), coordMask);
+			xValue += xStep * 4;
+			yValue += yStep * 4;
+
+			_mm_store_si128((__m128i*)(tileAddr + i), _mm_or_si128(_mm_slli_epi32(_mm_and_si128(yOffset, tileMask), 4), _mm_srai_epi32(xOffset, 3)));
+			_mm_store_si128((__m128i*)(pixelOffset + i), _mm_add_epi32(_mm_slli_epi32(_mm_and_si128(yOffset, offsetMask), 3), _mm_and_si128(xOffset, offsetMask)));
+			_mm_store_si128((__m128i*)(isOutsideMap + i), _mm_and_si128(_mm_or_si128(xOffset, yOffset), outsideMask));
+		}
+
+		for(int i = 0; i < 8; i++) {
+			colors[x + i] = fetchColor(tileAddr[i], pixelOffset[i], isOutsideMap[i] != 0);
+		}
+	}
+#endif
+
+	for(; x <= _drawEndX; x++) {
 		int32_t xOffset = xValue >> 8;
 		int32_t yOffset = yValue >> 8;
 		xValue += xStep;
 		yValue += yStep;
 
-		uint8_t tileIndex;
-		if(!_state.Mode7.LargeMap) {
+		if(!largeMap) {
 			yOffset &= 0x3FF;
 			xOffset &= 0x3FF;
-			tileIndex = (uint8_t)_vram[((yOffset & ~0x07) << 4) | (xOffset >> 3)];
-		} else {
-			if(yOffset < 0 || yOffset > 0x3FF || xOffset < 0 || xOffset > 0x3FF) {
-				if(_state.Mode7.FillWithTile0) {
-					tileIndex = 0;
-				} else {
-					//Draw nothing for this pixel, we're outside the map
-					continue;
-				}
-			} else {
-				tileIndex = (uint8_t)_vram[((yOffset & ~0x07) << 4) | (xOffset >> 3)];
-			}
+		}
+
+		bool isOutsideMap = yOffset < 0 || yOffset > 0x3FF || xOffset < 0 || xOffset > 0x3FF;
+		colors[x] = fetchColor(((yOffset & ~0x07) << 4) | (xOffset >> 3), ((yOffset & 0x07) << 3) + (xOffset & 0x07), isOutsideMap);
+	}
+
+	for(x = _drawStartX; x <= _drawEndX; x++) {
+		if(colors[x] == outsideMap) {
+			continue;
 		}
 
 		uint16_t colorIndex;
 		uint8_t priority;
 		if(layerIndex == 1) {
-			uint8_t color = _vram[((tileIndex << 6) + ((yOffset & 0x07) << 3) + (xOffset & 0x07))] >> 8;
+			uint8_t color = (uint8_t)colors[x];
 			priority = (color & 0x80) ? highPriority : normalPriority;
 			colorIndex = (color & 0x7F);
 		} else {
 			priority = normalPriority;
-			colorIndex = _vram[((tileIndex << 6) + ((yOffset & 0x07) << 3) + (xOffset & 0x07))] >> 8;
+			colorIndex = colors[x];
 		}
 
 		if(applyMosaic) {
@@ -1191,14 +1426,14 @@ void Ppu::RenderTilemapMode7()
 			if(directColorMode) {
 				paletteColor = ((colorIndex & 0x07) << 2) | ((colorIndex & 0x38) << 4) | ((colorIndex & 0xC0) << 7);
 			} else {
-				paletteColor = _cgram[colorIndex];
+				paletteColor = _cgram[colorIndex & 0xFF];
 			}
 			
-			if(drawMain && (_mainScreenFlags[x] & 0x0F) < priority && !ProcessMaskWindow<layerIndex>(mainWindowCount, x)) {
+			if(drawMain && (_mainScreenFlags[x] & 0x0F) < priority && !(windowMask[x] & mainWindowEnabled)) {
 				DrawMainPixel(x, paletteColor, priority | pixelFlags);
 			} 
 
-			if(drawSub && _subScreenPriority[x] < priority && !ProcessMaskWindow<layerIndex>(subWindowCount, x)) {
+			if(drawSub && _subScreenPriority[x] < priority && !(windowMask[x] & subWindowEnabled)) {
 				DrawSubPixel(x, paletteColor, priority);
 			}
 		}
@@ -1222,9 +1457,11 @@ void Ppu::ApplyColorMath()
 	uint8_t activeWindowCount = (uint8_t)_state.Window[0].ActiveLayers[Ppu::ColorWindowIndex] + (uint8_t)_state.Window[1].ActiveLayers[Ppu::ColorWindowIndex];
 	bool hiResMode = _state.HiResMode || _state.BgMode == 5 || _state.BgMode == 6;
 
+	ProcessMaskWindowSpan<Ppu::ColorWindowIndex>(activeWindowCount, _colorWindowMask);
+
 	if(hiResMode) {
 		for(int x = _drawStartX; x <= _drawEndX; x++) {
-			bool isInsideWindow = ProcessMaskWindow<Ppu::ColorWindowIndex>(activeWindowCount, x);
+			bool isInsideWindow = _colorWindowMask[x] != 0;
 
 			//Keep original subscreen color, which is used to apply color math to the main screen after
 			uint16_t subPixel = _subScreenBuffer[x];
@@ -1236,13 +1473,75 @@ void Ppu::ApplyColorMath()
 			ApplyColorMathToPixel(_mainScreenBuffer[x], subPixel, x, isInsideWindow);
 		}
 	} else {
-		for(int x = _drawStartX; x <= _drawEndX; x++) {
-			bool isInsideWindow = ProcessMaskWindow<Ppu::ColorWindowIndex>(activeWindowCount, x);
+		for(int x = ApplyColorMathBlocks(_drawStartX); x <= _drawEndX; x++) {
+			bool isInsideWindow = _colorWindowMask[x] != 0;
 			ApplyColorMathToPixel(_mainScreenBuffer[x], _subScreenBuffer[x], x, isInsideWindow);
 		}
 	}
 }
 
+#ifdef HAS_SSE2
+static __forceinline __m128i ApplyColorMathToChannel(__m128i a, __m128i b, __m128i halve, bool subtract)
+{
+	__m128i result = subtract ? _mm_subs_epu16(a, b) : _mm_add_epi16(a, b);
+	result = _mm_or_si128(_mm_and_si128(halve, _mm_srli_epi16(result, 1)), _mm_andnot_si128(halve, result));
+	return subtract ? result : _mm_min_epi16(result, _mm_set1_epi16(0x1F));
+}
+
+static __forceinline __m128i SelectWindowMode(ColorWindowMode mode, __m128i isInsideWindow)
+{
+	__m128i inside = _mm_set1_epi16(mode == ColorWindowMode::InsideWindow || mode == ColorWindowMode::Always ? -1 : 0);
+	__m128i outside = _mm_set1_epi16(mode == ColorWindowMode::OutsideWindow || mode == ColorWindowMode::Always ? -1 : 0);
+	return _mm_or_si128(_mm_and_si128(isInsideWindow, inside), _mm_andnot_si128(isInsideWindow, outside));
+}
+#endif
+
+int Ppu::ApplyColorMathBlocks(int x)
+{
+#ifdef HAS_SSE2
+	//Same logic as ApplyColorMathToPixel, 8 pixels at a time (each condition is turned into a mask)
+	//Returns the first pixel that still needs to be processed
+	bool subtract = _state.ColorMathSubstractMode;
+	__m128i zero = _mm_setzero_si128();
+	__m128i channelMask = _mm_set1_epi16(0x1F);
+	__m128i allowColorMath = _mm_set1_epi16(PixelFlags::AllowColorMath);
+	__m128i fixedColor = _mm_set1_epi16(_state.FixedColor);
+	__m128i addSubscreen = _mm_set1_epi16(_state.ColorMathAddSubscreen ? -1 : 0);
+	__m128i halveResult = _mm_set1_epi16(_state.ColorMathHalveResult ? -1 : 0);
+	//Setting the color to black disables the halve operation, except in "always" mode
+	__m128i clipDisablesHalve = _mm_set1_epi16(_state.ColorMathClipMode != ColorWindowMode::Always ? -1 : 0);
+
+	for(; x + 7 <= _drawEndX; x += 8) {
+		__m128i isInsideWindow = _mm_loadl_epi64((__m128i*)(_colorWindowMask + x));
+		isInsideWindow = _mm_unpacklo_epi8(isInsideWindow, isInsideWindow);
+		__m128i clip = SelectWindowMode(_state.ColorMathClipMode, isInsideWindow);
+		__m128i prevent = SelectWindowMode(_state.ColorMathPreventMode, isInsideWindow);
+
+		__m128i flags = _mm_unpacklo_epi8(_mm_loadl_epi64((__m128i*)(_mainScreenFlags + x)), zero);
+		__m128i applyColorMath = _mm_andnot_si128(prevent, _mm_cmpeq_epi16(_mm_and_si128(flags, allowColorMath), allowColorMath));
+
+		//When there's nothing in the subscreen, the fixed color is used instead and the halve operation is disabled
+		__m128i subPriority = _mm_unpacklo_epi8(_mm_loadl_epi64((__m128i*)(_subScreenPriority + x)), zero);
+		__m128i noSubPixel = _mm_and_si128(addSubscreen, _mm_cmpeq_epi16(subPriority, zero));
+		__m128i useSubPixel = _mm_andnot_si128(noSubPixel, addSubscreen);
+		__m128i halve = _mm_andnot_si128(_mm_or_si128(_mm_and_si128(clip, clipDisablesHalve), noSubPixel), halveResult);
+
+		__m128i pixelA = _mm_andnot_si128(clip, _mm_loadu_si128((__m128i*)(_mainScreenBuffer + x)));
+		__m128i pixelB = _mm_loadu_si128((__m128i*)(_subScreenBuffer + x));
+		pixelB = _mm_or_si128(_mm_and_si128(useSubPixel, pixelB), _mm_andnot_si128(useSubPixel, fixedColor));
+
+		__m128i r = ApplyColorMathToChannel(_mm_and_si128(pixelA, channelMask), _mm_and_si128(pixelB, channelMask), halve, subtract);
+		__m128i g = ApplyColorMathToChannel(_mm_and_si128(_mm_srli_epi16(pixelA, 5), channelMask), _mm_and_si128(_mm_srli_epi16(pixelB, 5), channelMask), halve, subtract);
+		__m128i b = ApplyColorMathToChannel(_mm_and_si128(_mm_srli_epi16(pixelA, 10), channelMask), _mm_and_si128(_mm_srli_epi16(pixelB, 10), channelMask), halve, subtract);
+		__m128i color = _mm_or_si128(r, _mm_or_si128(_mm_slli_epi16(g, 5), _mm_slli_epi16(b, 10)));
+
+		color = _mm_or_si128(_mm_and_si128(applyColorMath, color), _mm_andnot_si128(applyColorMath, pixelA));
+		_mm_storeu_si128((__m128i*)(_mainScreenBuffer + x), color);
+	}
+#endif
+	return x;
+}
+
 void Ppu::ApplyColorMathToPixel(uint16_t &pixelA, uint16_t pixelB, int x, bool isInsideWindow)
 {
 	uint8_t halfShift = (uint8_t)_state.ColorMathHalveResult;
@@ -1327,8 +1626,9 @@ template<bool forMainScreen>
 void Ppu::ApplyBrightness()
 {
 	if(_state.ScreenBrightness != 15) {
-		for(int x = _drawStartX; x <= _drawEndX; x++) {
-			uint16_t &pixel = (forMainScreen ? _mainScreenBuffer : _subScreenBuffer)[x];
+		uint16_t* buffer = forMainScreen ? _mainScreenBuffer : _subScreenBuffer;
+		for(int x = ApplyBrightnessBlocks(buffer, _drawStartX); x <= _drawEndX; x++) {
+			uint16_t &pixel = buffer[x];
 			uint16_t r = (pixel & 0x1F) * _state.ScreenBrightness / 15;
 			uint16_t g = ((pixel >> 5) & 0x1F) * _state.ScreenBrightness / 15;
 			uint16_t b = ((pixel >> 10) & 0x1F) * _state.ScreenBrightness / 15;
@@ -1337,6 +1637,25 @@ void Ppu::ApplyBrightness()
 	}
 }
 
+int Ppu::ApplyBrightnessBlocks(uint16_t* buffer, int x)
+{
+#ifdef HAS_SSE2
+	__m128i channelMask = _mm_set1_epi16(0x1F);
+	__m128i brightness = _mm_set1_epi16(_state.ScreenBrightness);
+	//(n * 4370) >> 16 gives the same result as n / 15, for any n <= 31 * 15
+	__m128i divideBy15 = _mm_set1_epi16(4370);
+
+	for(; x + 7 <= _drawEndX; x += 8) {
+		__m128i pixel = _mm_loadu_si128((__m128i*)(buffer + x));
+		__m128i r = _mm_mulhi_epu16(_mm_mullo_epi16(_mm_and_si128(pixel, channelMask), brightness), divideBy15);
+		__m128i g = _mm_mulhi_epu16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(pixel, 5), channelMask), brightness), divideBy15);
+		__m128i b = _mm_mulhi_epu16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(pixel, 10), channelMask), brightness), divideBy15);
+		_mm_storeu_si128((__m128i*)(buffer + x), _mm_or_si128(r, _mm_or_si128(_mm_slli_epi16(g, 5), _mm_slli_epi16(b, 10))));
+	}
+#endif
+	return x;
+}
+
 void Ppu::ConvertToHiRes()
 {
 	bool useHighResOutput = _useHighResOutput || IsDoubleWidth() || _state.ScreenInterlace;
@@ -1344,6 +1663,10 @@ void Ppu::ConvertToHiRes()
 		return;
 	}
 
+	if(_renderThread) {
+		_renderThread->WaitForJobs();
+	}
+
 	//Convert standard res picture to high resolution when the PPU starts drawing in high res mid frame
 	_useHighResOutput = useHighResOutput;
 
@@ -1374,7 +1697,6 @@ void Ppu::ApplyHiResMode()
 	if(!_useHighResOutput) {
 		memcpy(_currentBuffer + (scanline << 8) + _drawStartX, _mainScreenBuffer + _drawStartX, (_drawEndX - _drawStartX + 1) << 1);
 	} else {
-		_interlacedFrame |= _state.ScreenInterlace;
 		uint32_t screenY = _state.ScreenInterlace ? (_oddFrame ? ((scanline << 1) + 1) : (scanline << 1)) : (scanline << 1);
 		uint32_t baseAddr = (screenY << 9);
 
@@ -1403,25 +1725,45 @@ void Ppu::ApplyHiResMode()
 }
 
 template<uint8_t layerIndex>
-bool Ppu::ProcessMaskWindow(uint8_t activeWindowCount, int x)
+void Ppu::ProcessMaskWindowSpan(uint8_t activeWindowCount, uint8_t* mask)
 {
-	switch(activeWindowCount) {
-		case 1: 
-			if(_state.Window[0].ActiveLayers[layerIndex]) {
-				return _state.Window[0].PixelNeedsMasking<layerIndex>(x);
-			}
-			return _state.Window[1].PixelNeedsMasking<layerIndex>(x);
+	//Calculates the window mask for every pixel between _drawStartX and _drawEndX (0xFF when the pixel needs masking)
+	int start = _drawStartX;
+	int length = _drawEndX - _drawStartX + 1;
+	if(activeWindowCount == 0) {
+		memset(mask + start, 0, length);
+		return;
+	}
 
-		case 2:
-			switch(_state.MaskLogic[layerIndex]) {
-				default:
-				case WindowMaskLogic::Or: return _state.Window[0].PixelNeedsMasking<layerIndex>(x) | _state.Window[1].PixelNeedsMasking<layerIndex>(x);
-				case WindowMaskLogic::And: return _state.Window[0].PixelNeedsMasking<layerIndex>(x) & _state.Window[1].PixelNeedsMasking<layerIndex>(x);
-				case WindowMaskLogic::Xor: return _state.Window[0].PixelNeedsMasking<layerIndex>(x) ^ _state.Window[1].PixelNeedsMasking<layerIndex>(x);
-				case WindowMaskLogic::Xnor: return !(_state.Window[0].PixelNeedsMasking<layerIndex>(x) ^ _state.Window[1].PixelNeedsMasking<layerIndex>(x));
+	uint8_t windowMasks[2][256];
+	for(int i = 0; i < 2; i++) {
+		WindowConfig &window = _state.Window[i];
+		if(window.ActiveLayers[layerIndex]) {
+			bool inverted = window.InvertedLayers[layerIndex];
+			memset(windowMasks[i] + start, inverted ? 0xFF : 0, length);
+
+			int left = std::max<int>(window.Left, start);
+			int right = std::min<int>(window.Right, _drawEndX);
+			if(window.Left <= window.Right && left <= right) {
+				memset(windowMasks[i] + left, inverted ? 0 : 0xFF, right - left + 1);
 			}
+		}
+	}
+
+	if(activeWindowCount == 1) {
+		memcpy(mask + start, windowMasks[_state.Window[0].ActiveLayers[layerIndex] ? 0 : 1] + start, length);
+		return;
+	}
+
+	uint8_t* window0 = windowMasks[0];
+	uint8_t* window1 = windowMasks[1];
+	switch(_state.MaskLogic[layerIndex]) {
+		default:
+		case WindowMaskLogic::Or: for(int x = start; x <= _drawEndX; x++) { mask[x] = window0[x] | window1[x]; } break;
+		case WindowMaskLogic::And: for(int x = start; x <= _drawEndX; x++) { mask[x] = window0[x] & window1[x]; } break;
+		case WindowMaskLogic::Xor: for(int x = start; x <= _drawEndX; x++) { mask[x] = window0[x] ^ window1[x]; } break;
+		case WindowMaskLogic::Xnor: for(int x = start; x <= _drawEndX; x++) { mask[x] = ~(window0[x] ^ window1[x]); } break;
 	}
-	return false;
 }
 
 void Ppu::ProcessWindowMaskSettings(uint8_t value, uint8_t offset)
@@ -1439,10 +1781,14 @@ void Ppu::ProcessWindowMaskSettings(uint8_t value, uint8_t offset)
 
 void Ppu::SendFrame()
 {
+	if(_renderThread) {
+		_renderThread->WaitForJobs();
+	}
+
 	uint16_t width = _useHighResOutput ? 512 : 256;
 	uint16_t height = _useHighResOutput ? 478 : 239;
 
-	if(!_overscanFrame) {
+	if(!_overscanFrame && !_noVideoFrame) {
 		//Clear the top 7 and bottom 8 rows
 		int top = (_useHighResOutput ? 14 : 7);
 		int bottom = (_useHighResOutput ? 16 : 8);
@@ -1452,6 +1798,16 @@ void Ppu::SendFrame()
 
 	_console->GetNotificationManager()->SendNotification(ConsoleNotificationType::PpuFrameDone);
 
+	if(_console->IsRunAheadShadowActive()) {
+		//The run-ahead shadow console sends the frames that are displayed
+		return;
+	}
+
+	if(_noVideoFrame) {
+		//No-video mode, nothing was rendered
+		return;
+	}
+
 	bool isRewinding = _console->GetRewindManager()->IsRewinding();
 
 #ifdef LIBRETRO
@@ -1477,11 +1833,17 @@ bool Ppu::IsHighResOutput()
 
 uint16_t* Ppu::GetScreenBuffer()
 {
+	if(_renderThread) {
+		_renderThread->WaitForJobs();
+	}
 	return _currentBuffer;
 }
 
 uint16_t* Ppu::GetPreviousScreenBuffer()
 {
+	if(_renderThread) {
+		_renderThread->WaitForJobs();
+	}
 	return _currentBuffer == _outputBuffers[0] ? _outputBuffers[1] : _outputBuffers[0];
 }
 
@@ -1500,6 +1862,12 @@ uint8_t* Ppu::GetSpriteRam()
 	return (uint8_t*)_oamRam;
 }
 
+void Ppu::InvalidateSpriteLines()
+{
+	_dirtySpriteLines[0] = ~0ULL;
+	_dirtySpriteLines[1] = ~0ULL;
+}
+
 bool Ppu::IsDoubleHeight()
 {
 	return _state.ScreenInterlace && (_state.BgMode == 5 || _state.BgMode == 6);
@@ -1790,6 +2158,7 @@ void Ppu::Write(uint32_t addr, uint8_t value)
 	
 					_console->ProcessPpuWrite(oamAddr, value, SnesMemoryType::SpriteRam);
 					_oamRam[oamAddr] = value;
+					InvalidateSpriteLines(oamAddr);
 				} else {
 					_oamWriteBuffer = value;
 				}
@@ -1807,6 +2176,7 @@ void Ppu::Write(uint32_t addr, uint8_t value)
 				}
 				_console->ProcessPpuWrite(address, value, SnesMemoryType::SpriteRam);
 				_oamRam[address] = value;
+				InvalidateSpriteLines(address);
 			}
 			_internalOamAddress = (_internalOamAddress + 1) & 0x3FF;
 			break;
@@ -1911,6 +2281,10 @@ void Ppu::Write(uint32_t addr, uint8_t value)
 			//VMDATAL - VRAM Data Write low byte
 			if(_scanline >= _nmiScanline || _state.ForcedVblank) {
 				//Only write the value if in vblank or forced blank (writes to VRAM outside vblank/forced blank are not allowed)
+				if(_renderThread) {
+					//Mode 7 reads the tiles directly from video ram while drawing
+					_renderThread->WaitForJobs();
+				}
 				_console->ProcessPpuWrite(GetVramAddress() << 1, value, SnesMemoryType::VideoRam);
 				_vram[GetVramAddress()] = value | (_vram[GetVramAddress()] & 0xFF00);
 			}
@@ -1925,6 +2299,9 @@ void Ppu::Write(uint32_t addr, uint8_t value)
 			//VMDATAH - VRAM Data Write high byte
 			if(_scanline >= _nmiScanline || _state.ForcedVblank) {
 				//Only write the value if in vblank or forced blank (writes to VRAM outside vblank/forced blank are not allowed)
+				if(_renderThread) {
+					_renderThread->WaitForJobs();
+				}
 				_console->ProcessPpuWrite((GetVramAddress() << 1) + 1, value, SnesMemoryType::VideoRam);
 				_vram[GetVramAddress()] = (value << 8) | (_vram[GetVramAddress()] & 0xFF); 
 			}
@@ -2111,6 +2488,10 @@ void Ppu::Write(uint32_t addr, uint8_t value)
 
 void Ppu::Serialize(Serializer &s)
 {
+	if(_renderThread) {
+		_renderThread->WaitForJobs();
+	}
+
 	uint16_t unused_oamRenderAddress = 0;
 	s.Stream(
 		_state.ForcedVblank, _state.ScreenBrightness, _scanline, _frameCount, _drawStartX, _drawEndX, _state.BgMode,
@@ -2149,6 +2530,10 @@ void Ppu::Serialize(Serializer &s)
 	s.StreamArray(_vram, Ppu::VideoRamSize >> 1);
 	s.StreamArray(_oamRam, Ppu::SpriteRamSize);
 	s.StreamArray(_cgram, Ppu::CgRamSize >> 1);
+	if(!s.IsSaving()) {
+		_dirtySpriteLines[0] = ~0ULL;
+		_dirtySpriteLines[1] = ~0ULL;
+	}
 	
 	for(int i = 0; i < 4; i++) {
 		for(int j = 0; j < 33; j++) {
@@ -2159,6 +2544,9 @@ void Ppu::Serialize(Serializer &s)
 		}
 	}
 	s.Stream(_hOffset, _vOffset, _fetchBgStart, _fetchBgEnd, _fetchSpriteStart, _fetchSpriteEnd);
+
+	//Range check for the sprite whose position was read on the last evaluation cycle (states made before this was added load it as false)
+	s.Stream(_evalSpriteInRange);
 }
 
 void Ppu::RandomizeState()
@@ -9,6 +9,7 @@ class InternalRegisters;
 class MemoryManager;
 class Spc;
 class EmuSettings;
+class PpuRenderThread;
 
 class Ppu : public ISerializable
 {
@@ -18,6 +19,8 @@ public:
 	constexpr static uint32_t VideoRamSize = 0x10000;
 
 private:
+	friend class PpuRenderThread;
+
 	constexpr static int SpriteLayerIndex = 4;
 	constexpr static int ColorWindowIndex = 5;
 
@@ -42,12 +45,19 @@ private:
 	uint16_t _fetchSpriteEnd = 0;
 	uint16_t _spriteEvalStart = 0;
 	uint16_t _spriteEvalEnd = 0;
+	bool _evalSpriteInRange = false;
 	bool _spriteFetchingDone = false;
 	uint8_t _spriteIndexes[32] = {};
 	uint8_t _spriteCount = 0;
 	uint8_t _spriteTileCount = 0;
 	bool _hasSpritePriority[4] = {};
 
+	//Sprites that are in range on each scanline (1 bit per sprite, in OAM order), updated when OAM or the sprite size changes
+	uint64_t _spriteLineMasks[256][2] = {};
+	uint64_t _dirtySpriteLines[2] = { ~0ULL, ~0ULL };
+	uint8_t _spriteLinesOamMode = 0;
+	bool _spriteLinesObjInterlace = false;
+
 	uint16_t _scanline = 0;
 	uint32_t _frameCount = 0;
 
@@ -81,6 +91,9 @@ private:
 	uint8_t _subScreenPriority[256] = {};
 	uint16_t _subScreenBuffer[256] = {};
 
+	//Color window's state for each pixel of the current span (0xFF inside the window)
+	uint8_t _colorWindowMask[256] = {};
+
 	uint32_t _mosaicColor[4] = {};
 	uint32_t _mosaicPriority[4] = {};
 	uint16_t _mosaicScanlineCounter = 0;
@@ -105,6 +118,7 @@ private:
 
 	Timer _frameSkipTimer;
 	bool _skipRender = false;
+	bool _noVideoFrame = false;
 	uint8_t _configVisibleLayers = 0xFF;
 
 	uint8_t _spritePriority[256] = {};
@@ -114,6 +128,12 @@ private:
 	uint8_t _spritePaletteCopy[256] = {};
 	uint8_t _spriteColorsCopy[256] = {};
 
+	unique_ptr<PpuRenderThread> _renderThread;
+	bool _isRenderThreadPpu = false;
+
+	//Render-only instance used by PpuRenderThread (uses the main PPU's video ram)
+	Ppu(Ppu* mainPpu);
+
 	void RenderSprites(const uint8_t priorities[4]);
 
 	template<bool hiResMode>
@@ -135,6 +155,7 @@ private:
 	void RenderMode6();
 	void RenderMode7();
 
+	void RenderScanlineSegment();
 	void RenderBgColor();
 
 	template<uint8_t layerIndex, uint8_t bpp, uint8_t normalPriority, uint8_t highPriority, uint16_t basePaletteOffset = 0>
@@ -155,7 +176,7 @@ private:
 	__forceinline bool IsRenderRequired(uint8_t layerIndex);
 
 	template<uint8_t bpp>
-	__forceinline uint8_t GetTilePixelColor(const uint16_t chrData[4], const uint8_t shift);
+	__forceinline uint64_t GetTilePixelRow(const uint16_t chrData[4]);
 
 	template<uint8_t layerIndex, uint8_t normalPriority, uint8_t highPriority>
 	__forceinline void RenderTilemapMode7();
@@ -171,15 +192,17 @@ private:
 
 	void ApplyColorMath();
 	void ApplyColorMathToPixel(uint16_t &pixelA, uint16_t pixelB, int x, bool isInsideWindow);
+	int ApplyColorMathBlocks(int x);
 	
 	template<bool forMainScreen>
 	void ApplyBrightness();
+	int ApplyBrightnessBlocks(uint16_t* buffer, int x);
 
 	void ConvertToHiRes();
 	void ApplyHiResMode();
 
 	template<uint8_t layerIndex>
-	bool ProcessMaskWindow(uint8_t activeWindowCount, int x);
+	void ProcessMaskWindowSpan(uint8_t activeWindowCount, uint8_t* mask);
 
 	void ProcessWindowMaskSettings(uint8_t value, uint8_t offset);
 
@@ -192,6 +215,8 @@ private:
 	bool IsDoubleWidth();
 
 	void EvaluateNextLineSprites();
+	void InvalidateSpriteLines(uint16_t oamAddress);
+	void UpdateSpriteLines();
 	void FetchSpriteData();
 	__forceinline void FetchSpritePosition(uint16_t oamAddress);
 	void FetchSpriteAttributes(uint16_t oamAddress);
@@ -233,6 +258,8 @@ public:
 	uint8_t* GetVideoRam();
 	uint8_t* GetCgRam();
 	uint8_t* GetSpriteRam();
+	//Must be called after OAM is modified through GetSpriteRam's pointer (debugger tools)
+	void InvalidateSpriteLines();
 
 	void SetLocationLatchRequest(uint16_t x, uint16_t y);
 	void ProcessLocationLatchRequest();
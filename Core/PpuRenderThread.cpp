@@ -0,0 +1,142 @@
+#include "stdafx.h"
+#include "PpuRenderThread.h"
+#include "Ppu.h"
+
+PpuRenderThread::PpuRenderThread(Ppu* ppu)
+{
+	_ppu = ppu;
+	_renderer.reset(new Ppu(ppu));
+	_jobs.reset(new PpuRenderJob[PpuRenderThread::JobCount]);
+	_writePosition = 0;
+	_readPosition = 0;
+	_stopFlag = false;
+	_threadWaiting = false;
+
+	//The mosaic's last color can be carried over from a previous scanline
+	memcpy(_renderer->_mosaicColor, _ppu->_mosaicColor, sizeof(_ppu->_mosaicColor));
+	memcpy(_renderer->_mosaicPriority, _ppu->_mosaicPriority, sizeof(_ppu->_mosaicPriority));
+
+	_renderThread.reset(new thread(&PpuRenderThread::RenderThread, this));
+}
+
+PpuRenderThread::~PpuRenderThread()
+{
+	WaitForJobs();
+	_stopFlag = true;
+	_jobSignal.Signal();
+	_renderThread->join();
+
+	//Give the rendering state back to the main PPU, which renders the next scanlines itself
+	memcpy(_ppu->_mosaicColor, _renderer->_mosaicColor, sizeof(_ppu->_mosaicColor));
+	memcpy(_ppu->_mosaicPriority, _renderer->_mosaicPriority, sizeof(_ppu->_mosaicPriority));
+}
+
+void PpuRenderThread::AddJob()
+{
+	uint32_t writePosition = _writePosition;
+	if(writePosition - _readPosition >= PpuRenderThread::JobCount) {
+		//Queue is full, wait for the render thread to catch up
+		WaitForJobs();
+	}
+
+	PpuRenderJob &job = _jobs[writePosition % PpuRenderThread::JobCount];
+	job.State = _ppu->_state;
+	memcpy(job.Layers, _ppu->_layerData, sizeof(job.Layers));
+	memcpy(job.Cgram, _ppu->_cgram, sizeof(job.Cgram));
+
+	if(_ppu->_drawStartX == 0) {
+		memcpy(job.SpritePriority, _ppu->_spritePriority, sizeof(job.SpritePriority));
+		memcpy(job.SpritePalette, _ppu->_spritePalette, sizeof(job.SpritePalette));
+		memcpy(job.SpriteColors, _ppu->_spriteColors, sizeof(job.SpriteColors));
+	}
+
+	job.OutputBuffer = _ppu->_currentBuffer;
+	job.Scanline = _ppu->_scanline;
+	job.DrawStartX = _ppu->_drawStartX;
+	job.DrawEndX = _ppu->_drawEndX;
+	job.MosaicScanlineCounter = _ppu->_mosaicScanlineCounter;
+	job.OddFrame = _ppu->_oddFrame;
+	job.OverscanFrame = _ppu->_overscanFrame;
+	job.UseHighResOutput = _ppu->_useHighResOutput;
+	job.ConfigVisibleLayers = _ppu->_configVisibleLayers;
+
+	_writePosition = writePosition + 1;
+
+	if(job.DrawEndX == 255) {
+		//Only wake up the render thread once per scanline, and only if it is waiting for more jobs
+		WakeRenderThread();
+	}
+}
+
+void PpuRenderThread::WakeRenderThread()
+{
+	if(_threadWaiting.exchange(false)) {
+		_jobSignal.Signal();
+	}
+}
+
+void PpuRenderThread::WaitForJobs()
+{
+	if(_readPosition == _writePosition) {
+		return;
+	}
+
+	WakeRenderThread();
+
+	std::unique_lock<std::mutex> lock(_doneLock);
+	_doneSignal.wait(lock, [this] { return _readPosition == _writePosition; });
+}
+
+void PpuRenderThread::RenderThread()
+{
+	while(!_stopFlag) {
+		uint32_t readPosition = _readPosition;
+		while(readPosition != _writePosition) {
+			RenderJob(_jobs[readPosition % PpuRenderThread::JobCount]);
+			readPosition++;
+			_readPosition = readPosition;
+		}
+
+		{
+			std::unique_lock<std::mutex> lock(_doneLock);
+			_doneSignal.notify_all();
+		}
+
+		//Jobs added after this flag is set wake the thread up (the queue is checked again in case a job was added just before)
+		_threadWaiting = true;
+		if(_readPosition == _writePosition && !_stopFlag) {
+			_jobSignal.Wait();
+		}
+		_threadWaiting = false;
+	}
+}
+
+void PpuRenderThread::RenderJob(PpuRenderJob &job)
+{
+	Ppu* ppu = _renderer.get();
+
+	if(job.DrawStartX == 0) {
+		//Start of a new scanline
+		memcpy(ppu->_spritePriority, job.SpritePriority, sizeof(job.SpritePriority));
+		memcpy(ppu->_spritePalette, job.SpritePalette, sizeof(job.SpritePalette));
+		memcpy(ppu->_spriteColors, job.SpriteColors, sizeof(job.SpriteColors));
+		memset(ppu->_mainScreenFlags, 0, sizeof(ppu->_mainScreenFlags));
+		memset(ppu->_subScreenPriority, 0, sizeof(ppu->_subScreenPriority));
+	}
+
+	ppu->_state = job.State;
+	memcpy(ppu->_layerData, job.Layers, sizeof(job.Layers));
+	memcpy(ppu->_cgram, job.Cgram, sizeof(job.Cgram));
+
+	ppu->_currentBuffer = job.OutputBuffer;
+	ppu->_scanline = job.Scanline;
+	ppu->_drawStartX = job.DrawStartX;
+	ppu->_drawEndX = job.DrawEndX;
+	ppu->_mosaicScanlineCounter = job.MosaicScanlineCounter;
+	ppu->_oddFrame = job.OddFrame;
+	ppu->_overscanFrame = job.OverscanFrame;
+	ppu->_useHighResOutput = job.UseHighResOutput;
+	ppu->_configVisibleLayers = job.ConfigVisibleLayers;
+
+	ppu->RenderScanlineSegment();
+}
@@ -0,0 +1,68 @@
+#pragma once
+#include "stdafx.h"
+#include <condition_variable>
+#include "Ppu.h"
+#include "PpuTypes.h"
+#include "../Utilities/AutoResetEvent.h"
+
+//Everything the PPU's pixel rendering reads for a segment of a scanline, captured on the emulation thread
+struct PpuRenderJob
+{
+	PpuState State;
+	LayerData Layers[4];
+	uint16_t Cgram[Ppu::CgRamSize >> 1];
+
+	//Sprite data only changes at the end of a scanline, it is only copied for the scanline's first segment
+	uint8_t SpritePriority[256];
+	uint8_t SpritePalette[256];
+	uint8_t SpriteColors[256];
+
+	uint16_t* OutputBuffer;
+	uint16_t Scanline;
+	uint16_t DrawStartX;
+	uint16_t DrawEndX;
+	uint16_t MosaicScanlineCounter;
+	uint8_t OddFrame;
+	bool OverscanFrame;
+	bool UseHighResOutput;
+	uint8_t ConfigVisibleLayers;
+};
+
+//Renders the PPU's scanlines on a second thread.
+//The emulation thread keeps doing everything that has an effect on the emulation (tile/sprite fetching,
+//range/time over flags, latches, etc.) and queues a job each time a segment of a scanline needs to be drawn
+//(at the end of the scanline, or before a register write that could change the picture.)
+//The jobs are drawn, in order, by a render-only PPU instance that uses the main PPU's video ram.
+class PpuRenderThread
+{
+private:
+	static constexpr uint32_t JobCount = 128;
+
+	Ppu* _ppu;
+	unique_ptr<Ppu> _renderer;
+
+	unique_ptr<PpuRenderJob[]> _jobs;
+	atomic<uint32_t> _writePosition;
+	atomic<uint32_t> _readPosition;
+
+	unique_ptr<thread> _renderThread;
+	AutoResetEvent _jobSignal;
+	std::mutex _doneLock;
+	std::condition_variable _doneSignal;
+	atomic<bool> _stopFlag;
+	atomic<bool> _threadWaiting;
+
+	void WakeRenderThread();
+	void RenderThread();
+	void RenderJob(PpuRenderJob &job);
+
+public:
+	PpuRenderThread(Ppu* ppu);
+	~PpuRenderThread();
+
+	//Captures the state needed to draw the main PPU's current segment (_drawStartX to _drawEndX) and queues it
+	void AddJob();
+
+	//Blocks until all queued jobs are drawn - must be called before anything reads or alters the output buffer or video ram
+	void WaitForJobs();
+};
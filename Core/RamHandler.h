@@ -52,6 +52,17 @@ public:
 		_ram[addr & _mask] = value;
 	}
 
+	uint8_t* GetReadPointer() override
+	{
+		//Memory that's smaller than a page is mirrored within it, and can't be accessed directly
+		return _mask == 0xFFF ? _ram : nullptr;
+	}
+
+	uint8_t* GetWritePointer() override
+	{
+		return _mask == 0xFFF ? _ram : nullptr;
+	}
+
 	AddressInfo GetAbsoluteAddress(uint32_t address) override
 	{
 		AddressInfo info;
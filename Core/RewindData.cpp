@@ -4,28 +4,91 @@
 #include "SaveStateManager.h"
 #include "../Utilities/miniz.h"
 
-void RewindData::GetStateData(stringstream &stateData)
+static void CompressState(uint8_t* state, uint32_t size, vector<uint8_t> &output)
 {
-	stateData.write((char*)SaveStateData.data(), SaveStateData.size());
+	unsigned long compressedSize = compressBound(size);
+	output.resize(compressedSize);
+	compress2(output.data(), &compressedSize, state, size, 1);
+	output.resize(compressedSize);
+	output.shrink_to_fit();
 }
 
-void RewindData::LoadState(shared_ptr<Console> &console)
+void RewindData::GetUncompressedState(vector<uint8_t> &state)
+{
+	uint32_t size = KeyFrame->StateSize;
+	state.resize(size);
+
+	unsigned long decompSize = size;
+	uncompress(state.data(), &decompSize, KeyFrame->CompressedState.data(), (unsigned long)KeyFrame->CompressedState.size());
+
+	if(SaveStateData.size() > 0) {
+		vector<uint8_t> delta(size);
+		decompSize = size;
+		uncompress(delta.data(), &decompSize, SaveStateData.data(), (unsigned long)SaveStateData.size());
+		for(uint32_t i = 0; i < size; i++) {
+			state[i] ^= delta[i];
+		}
+	}
+}
+
+void RewindData::GetStateData(stringstream &stateData)
 {
+	if(!KeyFrame) {
+		return;
+	}
+
+	//Output the state in the same format as Console::Serialize
+	vector<uint8_t> compressedState;
 	if(SaveStateData.size() > 0) {
-		stringstream stream;
-		stream.write((char*)SaveStateData.data(), SaveStateData.size());
-		stream.seekg(0, ios::beg);
+		vector<uint8_t> state;
+		GetUncompressedState(state);
+		CompressState(state.data(), (uint32_t)state.size(), compressedState);
+	}
+
+	vector<uint8_t> &data = SaveStateData.size() > 0 ? compressedState : KeyFrame->CompressedState;
+	uint32_t compressedSize = (uint32_t)data.size();
+	stateData.write((char*)&KeyFrame->StateSize, sizeof(uint32_t));
+	stateData.write((char*)&compressedSize, sizeof(uint32_t));
+	stateData.write((char*)data.data(), data.size());
+}
 
-		console->Deserialize(stream, SaveStateManager::FileFormatVersion);
+void RewindData::LoadState(shared_ptr<Console> &console)
+{
+	if(KeyFrame) {
+		vector<uint8_t> state;
+		GetUncompressedState(state);
+		console->Deserialize(state.data(), (uint32_t)state.size(), SaveStateManager::FileFormatVersion);
 	}
 }
 
-void RewindData::SaveState(shared_ptr<Console> &console)
+void RewindData::SaveState(shared_ptr<Console> &console, shared_ptr<RewindKeyFrame> &keyFrame)
 {
-	std::stringstream state;
-	console->Serialize(state);
+	//Start with a buffer large enough for the state, to avoid reallocations while it is being saved
+	vector<uint8_t> state(keyFrame ? keyFrame->StateSize : 0x50000);
+	uint32_t size = console->Serialize(state);
+	state.resize(size);
+
+	if(!keyFrame || keyFrame->SegmentCount >= RewindData::KeyFrameInterval || keyFrame->StateSize != size) {
+		if(keyFrame) {
+			//Older segments only need the keyframe's compressed state
+			keyFrame->State = vector<uint8_t>();
+		}
+
+		keyFrame.reset(new RewindKeyFrame());
+		keyFrame->State = std::move(state);
+		keyFrame->StateSize = size;
+		CompressState(keyFrame->State.data(), size, keyFrame->CompressedState);
+		SaveStateData.clear();
+	} else {
+		uint8_t* delta = state.data();
+		uint8_t* keyFrameState = keyFrame->State.data();
+		for(uint32_t i = 0; i < size; i++) {
+			delta[i] ^= keyFrameState[i];
+		}
+		CompressState(delta, size, SaveStateData);
+	}
 
-	string data = state.str();
-	SaveStateData = vector<uint8_t>(data.c_str(), data.c_str()+data.size());
+	keyFrame->SegmentCount++;
+	KeyFrame = keyFrame;
 	FrameCount = 0;
 }
@@ -5,11 +5,28 @@
 
 class Console;
 
+struct RewindKeyFrame
+{
+	vector<uint8_t> CompressedState;
+	uint32_t StateSize = 0;
+	uint32_t SegmentCount = 0;
+
+	//Uncompressed copy of the state, only kept while new segments are still encoded against this keyframe
+	vector<uint8_t> State;
+};
+
 class RewindData
 {
 private:
+	//Each segment's state is stored as a XOR delta against the last keyframe (a full state saved every few segments)
+	//Since most of the state is unchanged between segments, the deltas compress much better than full states
+	static constexpr uint32_t KeyFrameInterval = 10;
+
+	shared_ptr<RewindKeyFrame> KeyFrame;
 	vector<uint8_t> SaveStateData;
 
+	void GetUncompressedState(vector<uint8_t> &state);
+
 public:
 	std::deque<ControlDeviceState> InputLogs[BaseControlDevice::PortCount];
 	int32_t FrameCount = 0;
@@ -18,5 +35,5 @@ public:
 	void GetStateData(stringstream &stateData);
 
 	void LoadState(shared_ptr<Console> &console);
-	void SaveState(shared_ptr<Console> &console);
+	void SaveState(shared_ptr<Console> &console, shared_ptr<RewindKeyFrame> &keyFrame);
 };
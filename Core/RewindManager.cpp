@@ -33,6 +33,7 @@ void RewindManager::ClearBuffer()
 	_history.clear();
 	_historyBackup.clear();
 	_currentHistory = RewindData();
+	_keyFrame.reset();
 	_framesToFastForward = 0;
 	_videoHistory.clear();
 	_videoHistoryBuilder.clear();
@@ -103,7 +104,7 @@ void RewindManager::AddHistoryBlock()
 			_history.push_back(_currentHistory);
 		}
 		_currentHistory = RewindData();
-		_currentHistory.SaveState(_console);
+		_currentHistory.SaveState(_console, _keyFrame);
 	}
 }
 
@@ -39,6 +39,7 @@ private:
 	std::deque<RewindData> _history;
 	std::deque<RewindData> _historyBackup;
 	RewindData _currentHistory;
+	shared_ptr<RewindKeyFrame> _keyFrame;
 
 	RewindState _rewindState;
 	int32_t _framesToFastForward;
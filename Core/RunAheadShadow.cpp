@@ -0,0 +1,153 @@
+#include "stdafx.h"
+#include "RunAheadShadow.h"
+#include "Console.h"
+#include "Ppu.h"
+#include "EmuSettings.h"
+#include "ControlManager.h"
+#include "BatteryManager.h"
+#include "CheatManager.h"
+#include "VideoDecoder.h"
+#include "VideoRenderer.h"
+
+RunAheadShadow::RunAheadShadow(Console* console)
+{
+	_console = console;
+	_cheatsChanged = false;
+	_stopFlag = false;
+
+	_shadow.reset(new Console());
+	_shadow->Initialize();
+
+	//The shadow console's frames are sent to the main console's video decoder
+	_shadow->GetVideoDecoder()->StopThread();
+	_shadow->GetVideoRenderer()->StopThread();
+
+	shared_ptr<EmuSettings> settings = _console->GetSettings();
+	shared_ptr<EmuSettings> shadowSettings = _shadow->GetSettings();
+	shadowSettings->SetEmulationConfig(settings->GetEmulationConfig());
+	shadowSettings->SetGameboyConfig(settings->GetGameboyConfig());
+	shadowSettings->SetInputConfig(settings->GetInputConfig());
+	shadowSettings->SetVideoConfig(settings->GetVideoConfig());
+	shadowSettings->SetFlag(EmulationFlags::NoFrontendOutput);
+
+	PreferencesConfig preferences = shadowSettings->GetPreferences();
+	preferences.RewindBufferSize = 0;
+	preferences.DisableGameSelectionScreen = true;
+	shadowSettings->SetPreferences(preferences);
+
+	RomInfo romInfo = _console->GetRomInfo();
+	if(_shadow->LoadRom(romInfo.RomFile, romInfo.PatchFile, false)) {
+		//Disable battery saving for this instance
+		_shadow->GetBatteryManager()->SetSaveEnabled(false);
+		_shadow->GetControlManager()->RegisterInputProvider(this);
+		_shadow->GetCheatManager()->SetCheats(_console->GetCheatManager()->GetCheats(), false);
+
+		_loaded = true;
+		_shadowThread.reset(new thread(&RunAheadShadow::ShadowThread, this));
+	}
+}
+
+RunAheadShadow::~RunAheadShadow()
+{
+	if(_shadowThread) {
+		WaitForFrame();
+		_stopFlag = true;
+		_startSignal.Signal();
+		_shadowThread->join();
+	}
+
+	shared_ptr<ControlManager> controlManager = _shadow->GetControlManager();
+	if(controlManager) {
+		controlManager->UnregisterInputProvider(this);
+	}
+	_shadow->Release();
+}
+
+bool RunAheadShadow::IsLoaded()
+{
+	return _loaded;
+}
+
+void RunAheadShadow::RunAhead(uint32_t frameCount)
+{
+	//The shadow console must be done with the previous frame before its state can be replaced
+	WaitForFrame();
+
+	shared_ptr<EmuSettings> settings = _console->GetSettings();
+	shared_ptr<EmuSettings> shadowSettings = _shadow->GetSettings();
+	shadowSettings->SetEmulationConfig(settings->GetEmulationConfig());
+	shadowSettings->SetVideoConfig(settings->GetVideoConfig());
+
+	if(_cheatsChanged) {
+		_cheatsChanged = false;
+		_shadow->GetCheatManager()->SetCheats(_console->GetCheatManager()->GetCheats(), false);
+	}
+
+	//Input polled at the end of this frame, the shadow console keeps it pressed for all the frames it runs ahead
+	for(shared_ptr<BaseControlDevice> &device : _console->GetControlManager()->GetControlDevices()) {
+		if(device->GetPort() < BaseControlDevice::PortCount) {
+			_inputState[device->GetPort()] = device->GetRawState();
+		}
+	}
+
+	_console->SaveSnapshot(_state);
+	_frameCount = frameCount;
+
+	_framePending = true;
+	_startSignal.Signal();
+}
+
+void RunAheadShadow::WaitForFrame()
+{
+	if(_framePending) {
+		_frameDone.Wait();
+		_framePending = false;
+	}
+}
+
+void RunAheadShadow::ShadowThread()
+{
+	while(true) {
+		_startSignal.Wait();
+		if(_stopFlag) {
+			break;
+		}
+
+		_shadow->RunShadowFrames(_state, _frameCount);
+		SendFrame();
+
+		_frameDone.Signal();
+	}
+}
+
+void RunAheadShadow::SendFrame()
+{
+	shared_ptr<Ppu> ppu = _shadow->GetPpu();
+	uint16_t width = ppu->IsHighResOutput() ? 512 : 256;
+	uint16_t height = ppu->IsHighResOutput() ? 478 : 239;
+
+	//The decoder reads the frame asynchronously, and is done with it by the time the next frame is sent - alternate between 2 buffers
+	vector<uint16_t> &frameBuffer = _frameBuffers[_frameBufferIndex];
+	_frameBufferIndex ^= 1;
+
+	uint16_t* screenBuffer = ppu->GetScreenBuffer();
+	frameBuffer.assign(screenBuffer, screenBuffer + width * height);
+	_console->GetVideoDecoder()->UpdateFrame(frameBuffer.data(), width, height, ppu->GetFrameCount());
+}
+
+bool RunAheadShadow::SetInput(BaseControlDevice* device)
+{
+	if(device->GetPort() >= BaseControlDevice::PortCount) {
+		return false;
+	}
+
+	device->SetRawState(_inputState[device->GetPort()]);
+	return true;
+}
+
+void RunAheadShadow::ProcessNotification(ConsoleNotificationType type, void* parameter)
+{
+	if(type == ConsoleNotificationType::CheatsChanged) {
+		_cheatsChanged = true;
+	}
+}
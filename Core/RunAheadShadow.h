@@ -0,0 +1,54 @@
+#pragma once
+#include "stdafx.h"
+#include "Console.h"
+#include "IInputProvider.h"
+#include "INotificationListener.h"
+#include "BaseControlDevice.h"
+#include "ControlDeviceState.h"
+#include "../Utilities/AutoResetEvent.h"
+
+//Run-ahead using a second console instance, running on its own thread.
+//The main console keeps running the real timeline (with audio output) and never reloads its state,
+//while this shadow console loads the main console's state after each frame, runs ahead with the same input
+//and sends its last frame to the main console's video decoder.
+class RunAheadShadow : public IInputProvider, public INotificationListener
+{
+private:
+	Console* _console;
+	shared_ptr<Console> _shadow;
+	bool _loaded = false;
+
+	ConsoleSnapshot _state;
+	ControlDeviceState _inputState[BaseControlDevice::PortCount];
+	uint32_t _frameCount = 0;
+	atomic<bool> _cheatsChanged;
+
+	vector<uint16_t> _frameBuffers[2];
+	uint8_t _frameBufferIndex = 0;
+
+	unique_ptr<thread> _shadowThread;
+	AutoResetEvent _startSignal;
+	AutoResetEvent _frameDone;
+	atomic<bool> _stopFlag;
+	bool _framePending = false;
+
+	void ShadowThread();
+	void SendFrame();
+
+public:
+	RunAheadShadow(Console* console);
+	virtual ~RunAheadShadow();
+
+	//False if the game could not be loaded on the shadow console
+	bool IsLoaded();
+
+	//Called by the main console at the end of each frame: starts running the shadow console ahead from the main console's current state
+	void RunAhead(uint32_t frameCount);
+	void WaitForFrame();
+
+	// Inherited via IInputProvider
+	bool SetInput(BaseControlDevice* device) override;
+
+	// Inherited via INotificationListener
+	void ProcessNotification(ConsoleNotificationType type, void* parameter) override;
+};
@@ -21,6 +21,7 @@ Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA */
 #include "blargg_source.h"
 #include "Spc.h"
 #include "EmuSettings.h"
+#include "../Utilities/SimdUtilities.h"
 
 #ifdef BLARGG_ENABLE_OPTIMIZER
 	#include BLARGG_ENABLE_OPTIMIZER
@@ -323,6 +324,28 @@ inline void SPC_DSP::decode_brr( voice_t* v )
 	if ( (v->buf_pos += 4) >= brr_buf_size )
 		v->buf_pos = 0;
 	
+	// Looping samples decode the same blocks over and over, usually with the same filter
+	// history, reuse the previous result when all the inputs match. The history is left
+	// out of the key when the block's filter doesn't use it.
+	int const filter_type = header & 0x0C;
+	uint64_t key = ((uint64_t) 1 << 56) | ((uint64_t) header << 48) | ((uint64_t) nybbles << 32);
+	if ( filter_type )
+	{
+		key |= (uint64_t) (uint16_t) pos [brr_buf_size - 1] << 16;
+		if ( filter_type >= 8 )
+			key |= (uint16_t) pos [brr_buf_size - 2];
+	}
+	
+	BrrCacheEntry& entry = _brrCache [(v->brr_addr + v->brr_offset) & (BrrCacheSize - 1)];
+	if ( entry.key == key )
+	{
+		for ( int i = 0; i < 4; i++ )
+			pos [brr_buf_size + i] = pos [i] = entry.samples [i];
+		return;
+	}
+	entry.key = key;
+	int16_t* cached = entry.samples;
+	
 	// Decode four samples
 	for ( end = pos + 4; pos < end; pos++, nybbles <<= 4 )
 	{
@@ -364,6 +387,7 @@ inline void SPC_DSP::decode_brr( voice_t* v )
 		CLAMP16( s );
 		s = (int16_t) (s * 2);
 		pos [brr_buf_size] = pos [0] = s; // second copy simplifies wrap-around
+		*cached++ = s;
 	}
 }
 
@@ -471,7 +495,7 @@ VOICE_CLOCK( V3c )
 	
 	// Gaussian interpolation
 	{
-		int output = _settings->GetAudioConfig().EnableCubicInterpolation ? interpolate_cubic(v) : interpolate( v );
+		int output = _cubicInterpolation ? interpolate_cubic(v) : interpolate( v );
 		
 		// Noise
 		if ( m.t_non & v->vbit )
@@ -627,6 +651,74 @@ inline void SPC_DSP::echo_read( int ch )
 	ECHO_FIR( 0 ) [ch] = ECHO_FIR( 8 ) [ch] = s >> 1;
 }
 
+// The hardware calculates tap 0 on clock 22, taps 1-2 on clock 23, taps 3-5 on clock 24
+// and taps 6-7 on clock 25. Taps 0-6 are all calculated on clock 22 here instead, and
+// write_fir() adjusts the sum when a coefficient changes before its tap's clock.
+// First tap calculated by the hardware on clocks 23, 24 and 25:
+static int const echo_fir_first_tap [3] = { 1, 3, 6 };
+
+// Adds taps 0-6 for both channels to t_echo_in
+inline void SPC_DSP::echo_fir()
+{
+#ifdef HAS_SSE2
+	// History samples fit in 16 bits, each 32-bit product is made from its low/high halves
+	__m128i const* hist = (__m128i const*) m.echo_hist_pos [1];
+	__m128i const* coefs = (__m128i const*) _echoFirCoefs;
+	__m128i sum = _mm_setzero_si128();
+	for ( int i = 0; i < 2; i++ )
+	{
+		__m128i samples = _mm_packs_epi32( _mm_loadu_si128( hist + i * 2 ), _mm_loadu_si128( hist + i * 2 + 1 ) );
+		__m128i lo = _mm_mullo_epi16( samples, coefs [i] );
+		__m128i hi = _mm_mulhi_epi16( samples, coefs [i] );
+		sum = _mm_add_epi32( sum, _mm_srai_epi32( _mm_unpacklo_epi16( lo, hi ), 6 ) );
+		sum = _mm_add_epi32( sum, _mm_srai_epi32( _mm_unpackhi_epi16( lo, hi ), 6 ) );
+	}
+	
+	// Lanes are left/right/left/right
+	sum = _mm_add_epi32( sum, _mm_unpackhi_epi64( sum, sum ) );
+	m.t_echo_in [0] = _mm_cvtsi128_si32( sum );
+	m.t_echo_in [1] = _mm_cvtsi128_si32( _mm_srli_si128( sum, 4 ) );
+#else
+	for ( int ch = 0; ch < 2; ch++ )
+	{
+		int sum = 0;
+		for ( int i = 0; i < 7; i++ )
+			sum += CALC_FIR( i, ch );
+		m.t_echo_in [ch] = sum;
+	}
+#endif
+}
+
+// Sum of the taps the hardware hasn't calculated yet (but that echo_fir() already added)
+int SPC_DSP::echo_fir_pending( int ch )
+{
+	if ( m.phase < 23 || m.phase > 25 )
+		return 0;
+	
+	int sum = 0;
+	for ( int i = echo_fir_first_tap [m.phase - 23]; i < 7; i++ )
+		sum += CALC_FIR( i, ch );
+	return sum;
+}
+
+void SPC_DSP::write_fir( int tap, int old_coef )
+{
+	update_fir_coefs();
+	
+	if ( tap < 7 && m.phase >= 23 && m.phase <= 25 && tap >= echo_fir_first_tap [m.phase - 23] )
+	{
+		// Tap was already added on clock 22 using the old coefficient
+		for ( int ch = 0; ch < 2; ch++ )
+			m.t_echo_in [ch] += CALC_FIR( tap, ch ) - ((ECHO_FIR( tap + 1 ) [ch] * (int8_t) old_coef) >> 6);
+	}
+}
+
+void SPC_DSP::update_fir_coefs()
+{
+	for ( int i = 0; i < 7; i++ )
+		_echoFirCoefs [i * 2] = _echoFirCoefs [i * 2 + 1] = (int8_t) REG(fir + i * 0x10);
+}
+
 ECHO_CLOCK( 22 )
 {
 	// History
@@ -636,38 +728,17 @@ ECHO_CLOCK( 22 )
 	m.t_echo_ptr = (m.t_esa * 0x100 + m.echo_offset) & 0xFFFF;
 	echo_read( 0 );
 	
-	// FIR (using l and r temporaries below helps compiler optimize)
-	int l = CALC_FIR( 0, 0 );
-	int r = CALC_FIR( 0, 1 );
-	
-	m.t_echo_in [0] = l;
-	m.t_echo_in [1] = r;
+	// FIR
+	echo_fir();
 }
 ECHO_CLOCK( 23 )
 {
-	int l = CALC_FIR( 1, 0 ) + CALC_FIR( 2, 0 );
-	int r = CALC_FIR( 1, 1 ) + CALC_FIR( 2, 1 );
-	
-	m.t_echo_in [0] += l;
-	m.t_echo_in [1] += r;
-	
 	echo_read( 1 );
 }
-ECHO_CLOCK( 24 )
-{
-	int l = CALC_FIR( 3, 0 ) + CALC_FIR( 4, 0 ) + CALC_FIR( 5, 0 );
-	int r = CALC_FIR( 3, 1 ) + CALC_FIR( 4, 1 ) + CALC_FIR( 5, 1 );
-	
-	m.t_echo_in [0] += l;
-	m.t_echo_in [1] += r;
-}
 ECHO_CLOCK( 25 )
 {
-	int l = m.t_echo_in [0] + CALC_FIR( 6, 0 );
-	int r = m.t_echo_in [1] + CALC_FIR( 6, 1 );
-	
-	l = (int16_t) l;
-	r = (int16_t) r;
+	int l = (int16_t) m.t_echo_in [0];
+	int r = (int16_t) m.t_echo_in [1];
 	
 	l += (int16_t) CALC_FIR( 7, 0 );
 	r += (int16_t) CALC_FIR( 7, 1 );
@@ -801,7 +872,7 @@ PHASE(20)         V(V1,1)                            V(V7,6)V(V4,7)\
 PHASE(21)                                            V(V8,6)V(V5,7)  V(V2,0)  /* t_brr_next_addr order dependency */\
 PHASE(22)  V(V3a,0)                                  V(V9,6)V(V6,7)  echo_22();\
 PHASE(23)                                                   V(V7,7)  echo_23();\
-PHASE(24)                                                   V(V8,7)  echo_24();\
+PHASE(24)                                                   V(V8,7)\
 PHASE(25)  V(V3b,0)                                         V(V9,7)  echo_25();\
 PHASE(26)                                                            echo_26();\
 PHASE(27) misc_27();                                                 echo_27();\
@@ -812,15 +883,25 @@ PHASE(31)  V(V4,0)       V(V1,2)\
 
 #if !SPC_DSP_CUSTOM_RUN
 
-void SPC_DSP::run()
+void SPC_DSP::run( int clocks_remain )
 {
+	require( clocks_remain > 0 );
+	
+	// Setting only needs to be checked once per batch of clocks
+	_cubicInterpolation = _settings->GetAudioConfig().EnableCubicInterpolation;
+	
 	int const phase = m.phase;
-	m.phase = (phase + 1) & 31;
-	switch (phase)
+	m.phase = (phase + clocks_remain) & 31;
+	switch ( phase )
 	{
-		#define PHASE( n ) if ( n ) break; case n:
+	loop:
+	
+		#define PHASE( n ) if ( n && !--clocks_remain ) break; case n:
 		GEN_DSP_TIMING
 		#undef PHASE
+	
+		if ( --clocks_remain )
+			goto loop;
 	}
 }
 
@@ -830,6 +911,81 @@ inline void SPC_DSP::writeRam(uint16_t addr, uint8_t value) { _spc->DspWriteRam(
 #endif
 
 
+//// RAM access tracking
+
+static void mark_ram_range( uint8_t* pages, int addr, int size )
+{
+	int page = (addr >> 8) & 0xFF;
+	int const last_page = ((addr + size - 1) >> 8) & 0xFF;
+	while ( true )
+	{
+		pages [page] = 1;
+		if ( page == last_page )
+			break;
+		page = (page + 1) & 0xFF;
+	}
+}
+
+void SPC_DSP::markRamPages( uint8_t* pages, int sample_count )
+{
+	// Echo buffer: 4 bytes are read and written per sample, from the current offset
+	// or from the start of the buffer once it wraps around. ESA is only latched
+	// once per sample, so both the latched and the register's value can be used.
+	int const echo_size = (sample_count + 2) * 4;
+	int const esa [2] = { m.t_esa, REG(esa) };
+	mark_ram_range( pages, m.t_echo_ptr, 4 );
+	for ( int i = 0; i < 2; i++ )
+	{
+		mark_ram_range( pages, esa [i] * 0x100 + m.echo_offset, echo_size );
+		mark_ram_range( pages, esa [i] * 0x100, echo_size );
+	}
+	
+	// Sample directory (DIR is also latched once per sample)
+	int const dir [2] = { m.t_dir, REG(dir) };
+	for ( int i = 0; i < 2; i++ )
+	{
+		int const first_page = dir [i];
+		for ( int j = 0; j < 4; j++ )
+		{
+			if ( pages [(first_page + j) & 0xFF] )
+			{
+				// Echo writes could change the directory's content, the sample
+				// addresses below can't be known in advance
+				memset( pages, 1, 0x100 );
+				return;
+			}
+		}
+	}
+	for ( int i = 0; i < 2; i++ )
+		mark_ram_range( pages, dir [i] * 0x100, 0x400 );
+	mark_ram_range( pages, m.t_dir_addr, 4 );
+	
+	// BRR data: at most 4 samples (2 bytes) are decoded per output sample, starting
+	// from the current block, or from the start/loop address of the voice's source
+	int const brr_size = (sample_count / 4 + 3) * brr_block_size;
+	mark_ram_range( pages, m.t_brr_next_addr, brr_size );
+	for ( int v = 0; v < voice_count; v++ )
+	{
+		voice_t const* voice = &m.voices [v];
+		mark_ram_range( pages, voice->brr_addr, brr_size );
+		
+		int const srcn [2] = { VREG(voice->regs,srcn), m.t_srcn };
+		for ( int i = 0; i < 2; i++ )
+		{
+			for ( int j = 0; j < 2; j++ )
+			{
+				int const entry = dir [i] * 0x100 + srcn [j] * 4;
+				for ( int k = 0; k < 4; k += 2 )
+				{
+					int const addr = m.ram [(entry + k) & 0xFFFF] | (m.ram [(entry + k + 1) & 0xFFFF] << 8);
+					mark_ram_range( pages, addr, brr_size );
+				}
+			}
+		}
+	}
+}
+
+
 //// Setup
 
 void SPC_DSP::init( Spc *spc, EmuSettings *settings, void* ram_64k )
@@ -893,6 +1049,7 @@ void SPC_DSP::load( uint8_t const regs [register_count] )
 	m.new_kon = REG(kon);
 	m.t_dir   = REG(dir);
 	m.t_esa   = REG(esa);
+	update_fir_coefs();
 	
 	soft_reset_common();
 }
@@ -949,6 +1106,7 @@ void SPC_DSP::copy_state( unsigned char** io, copy_func_t copy )
 	
 	// DSP registers
 	copier.copy( m.regs, register_count );
+	update_fir_coefs();
 	
 	// Internal state
 	
@@ -1031,8 +1189,15 @@ void SPC_DSP::copy_state( unsigned char** io, copy_func_t copy )
 	SPC_COPY(  int16_t, m.t_main_out [1] );
 	SPC_COPY(  int16_t, m.t_echo_out [0] );
 	SPC_COPY(  int16_t, m.t_echo_out [1] );
-	SPC_COPY(  int16_t, m.t_echo_in  [0] );
-	SPC_COPY(  int16_t, m.t_echo_in  [1] );
+	
+	// Only the taps the hardware has calculated so far are part of the saved state
+	for ( i = 0; i < 2; i++ )
+	{
+		int pending = echo_fir_pending( i );
+		int s = (int16_t) (m.t_echo_in [i] - pending);
+		SPC_COPY(  int16_t, s );
+		m.t_echo_in [i] = s + pending;
+	}
 	
 	SPC_COPY( uint16_t, m.t_dir_addr );
 	SPC_COPY( uint16_t, m.t_pitch );
@@ -43,7 +43,12 @@ public:
 
 	// Runs DSP for specified number of clocks (~1024000 per second). Every 32 clocks
 	// a pair of samples is be generated.
-	void run();
+	void run( int clock_count );
+	
+	// Marks each 256-byte page of RAM the DSP could read or write while it generates
+	// the next sample_count samples (sets pages[page] to 1). Only valid until a DSP
+	// register or one of the marked pages is written to.
+	void markRamPages( uint8_t* pages, int sample_count );
 	
 	bool isMuted() { return (m.regs[r_flg] & 0x40) != 0; }
 	void copyRegs(uint8_t* output) { memcpy(output, m.regs, register_count); }
@@ -193,6 +198,21 @@ private:
 	state_t m;
 	Spc* _spc;
 	EmuSettings* _settings;
+	bool _cubicInterpolation = true;
+	
+	// Decoded samples for each group of 4 BRR samples, indexed by the group's address in RAM.
+	// Entries are keyed by every input of the decoding (header, nybbles & filter history), so
+	// they never need to be invalidated (and are not part of the DSP's state)
+	struct BrrCacheEntry
+	{
+		uint64_t key;
+		int16_t samples[4];
+	};
+	static constexpr int BrrCacheSize = 0x1000;
+	BrrCacheEntry _brrCache[BrrCacheSize] = {};
+	
+	// FIR coefficients for taps 0-6, repeated for the left & right channels (tap 7 is left at 0)
+	alignas(16) int16_t _echoFirCoefs[16] = {};
 	
 	void init_counter();
 	void run_counters();
@@ -226,11 +246,14 @@ private:
 	void voice_V9_V6_V3( voice_t* const );
 
 	void echo_read( int ch );
+	void echo_fir();
+	int  echo_fir_pending( int ch );
+	void write_fir( int tap, int old_coef );
+	void update_fir_coefs();
 	int  echo_output( int ch );
 	void echo_write( int ch );
 	void echo_22();
 	void echo_23();
-	void echo_24();
 	void echo_25();
 	void echo_26();
 	void echo_27();
@@ -255,6 +278,7 @@ inline void SPC_DSP::write( int addr, int data )
 {
 	assert( (unsigned) addr < register_count );
 	
+	int const old = m.regs [addr];
 	m.regs [addr] = (uint8_t) data;
 	switch ( addr & 0x0F )
 	{
@@ -276,6 +300,10 @@ inline void SPC_DSP::write( int addr, int data )
 			m.regs [r_endx] = 0;
 		}
 		break;
+	
+	case 0x0F:
+		write_fir( addr >> 4, old );
+		break;
 	}
 }
 
@@ -1,20 +1,21 @@
 #include "stdafx.h"
 #include "ScaleFilter.h"
+#include "VideoFilterThreadPool.h"
 #include "../Utilities/xBRZ/xbrz.h"
 #include "../Utilities/HQX/hqx.h"
 #include "../Utilities/Scale2x/scalebit.h"
 #include "../Utilities/KreedSaiEagle/SaiEagle.h"
 
-bool ScaleFilter::_hqxInitDone = false;
+std::once_flag ScaleFilter::_hqxInitFlag;
 
 ScaleFilter::ScaleFilter(ScaleFilterType scaleFilterType, uint32_t scale)
 {
 	_scaleFilterType = scaleFilterType;
 	_filterScale = scale;
 
-	if(!_hqxInitDone && _scaleFilterType == ScaleFilterType::HQX) {
-		hqxInit();
-		_hqxInitDone = true;
+	if(_scaleFilterType == ScaleFilterType::HQX) {
+		//The HQX lookup tables are shared by all instances, build them only once
+		std::call_once(_hqxInitFlag, hqxInit);
 	}
 }
 
@@ -28,11 +29,12 @@ uint32_t ScaleFilter::GetScale()
 	return _filterScale;
 }
 
-void ScaleFilter::ApplyPrescaleFilter(uint32_t *inputArgbBuffer)
+void ScaleFilter::ApplyPrescaleFilter(uint32_t *inputArgbBuffer, uint32_t yFirst, uint32_t yLast)
 {
-	uint32_t* outputBuffer = _outputBuffer;
+	uint32_t* outputBuffer = _outputBuffer + yFirst * _width * _filterScale * _filterScale;
+	inputArgbBuffer += yFirst * _width;
 
-	for(uint32_t y = 0; y < _height; y++) {
+	for(uint32_t y = yFirst; y < yLast; y++) {
 		for(uint32_t x = 0; x < _width; x++) {
 			for(uint32_t i = 0; i < _filterScale; i++) {
 				*(outputBuffer++) = *inputArgbBuffer;
@@ -56,32 +58,53 @@ void ScaleFilter::UpdateOutputBuffer(uint32_t width, uint32_t height)
 	}
 }
 
-uint32_t* ScaleFilter::ApplyFilter(uint32_t *inputArgbBuffer, uint32_t width, uint32_t height, double scanlineIntensity)
+void ScaleFilter::ScaleImage(uint32_t *inputArgbBuffer, uint32_t *outputBuffer, uint32_t width, uint32_t height)
 {
-	UpdateOutputBuffer(width, height);
-
-	if(_scaleFilterType == ScaleFilterType::xBRZ) {
-		xbrz::scale(_filterScale, inputArgbBuffer, _outputBuffer, width, height, xbrz::ColorFormat::ARGB);
-	} else if(_scaleFilterType == ScaleFilterType::HQX) {
-		hqx(_filterScale, inputArgbBuffer, _outputBuffer, width, height);
+	if(_scaleFilterType == ScaleFilterType::HQX) {
+		hqx(_filterScale, inputArgbBuffer, outputBuffer, width, height);
 	} else if(_scaleFilterType == ScaleFilterType::Scale2x) {
-		scale(_filterScale, _outputBuffer, width*sizeof(uint32_t)*_filterScale, inputArgbBuffer, width*sizeof(uint32_t), 4, width, height);
+		scale(_filterScale, outputBuffer, width*sizeof(uint32_t)*_filterScale, inputArgbBuffer, width*sizeof(uint32_t), 4, width, height);
 	} else if(_scaleFilterType == ScaleFilterType::_2xSai) {
-		twoxsai_generic_xrgb8888(width, height, inputArgbBuffer, width, _outputBuffer, width * _filterScale);
+		twoxsai_generic_xrgb8888(width, height, inputArgbBuffer, width, outputBuffer, width * _filterScale);
 	} else if(_scaleFilterType == ScaleFilterType::Super2xSai) {
-		supertwoxsai_generic_xrgb8888(width, height, inputArgbBuffer, width, _outputBuffer, width * _filterScale);
+		supertwoxsai_generic_xrgb8888(width, height, inputArgbBuffer, width, outputBuffer, width * _filterScale);
 	} else if(_scaleFilterType == ScaleFilterType::SuperEagle) {
-		supereagle_generic_xrgb8888(width, height, inputArgbBuffer, width, _outputBuffer, width * _filterScale);
+		supereagle_generic_xrgb8888(width, height, inputArgbBuffer, width, outputBuffer, width * _filterScale);
+	}
+}
+
+void ScaleFilter::ApplyFilter(uint32_t *inputArgbBuffer, double scanlineIntensity, const VideoFilterStripe &stripe)
+{
+	uint32_t yFirst = stripe.FirstRow;
+	uint32_t yLast = stripe.LastRow;
+	uint32_t outputWidth = _width * _filterScale;
+
+	if(_scaleFilterType == ScaleFilterType::xBRZ) {
+		xbrz::scale(_filterScale, inputArgbBuffer, _outputBuffer, _width, _height, xbrz::ColorFormat::ARGB, xbrz::ScalerCfg(), yFirst, yLast);
 	} else if(_scaleFilterType == ScaleFilterType::Prescale) {
-		ApplyPrescaleFilter(inputArgbBuffer);
+		ApplyPrescaleFilter(inputArgbBuffer, yFirst, yLast);
+	} else if(yFirst == 0 && yLast == _height) {
+		ScaleImage(inputArgbBuffer, _outputBuffer, _width, _height);
+	} else {
+		//These filters can only process whole images: scale the stripe along with the rows around it (so the
+		//stripe's edges use the same neighbors as when scaling the whole frame), and keep the stripe's rows only
+		uint32_t top = stripe.Top;
+		uint32_t bottom = stripe.Bottom;
+		vector<uint32_t> &stripeBuffer = _stripeBuffers[stripe.Index];
+		stripeBuffer.resize((bottom - top) * _filterScale * outputWidth);
+		ScaleImage(inputArgbBuffer + top * _width, stripeBuffer.data(), _width, bottom - top);
+
+		uint32_t rowSize = _filterScale * outputWidth;
+		memcpy(_outputBuffer + yFirst * rowSize, stripeBuffer.data() + (yFirst - top) * rowSize, (yLast - yFirst) * rowSize * sizeof(uint32_t));
 	}
 
 	scanlineIntensity = 1.0 - scanlineIntensity;
 
 	if(scanlineIntensity < 1.0) {
-		for(int y = 1, yMax = height * _filterScale; y < yMax; y += 2) {
-			for(int x = 0, xMax = width * _filterScale; x < xMax; x++) {
-				uint32_t &color = _outputBuffer[y*xMax + x];
+		//Darken every other row of the stripe's output
+		for(uint32_t y = yFirst * _filterScale | 1, yMax = yLast * _filterScale; y < yMax; y += 2) {
+			for(uint32_t x = 0; x < outputWidth; x++) {
+				uint32_t &color = _outputBuffer[y*outputWidth + x];
 				uint8_t r = (color >> 16) & 0xFF, g = (color >> 8) & 0xFF, b = color & 0xFF;
 				r = (uint8_t)(r * scanlineIntensity);
 				g = (uint8_t)(g * scanlineIntensity);
@@ -90,6 +113,16 @@ uint32_t* ScaleFilter::ApplyFilter(uint32_t *inputArgbBuffer, uint32_t width, ui
 			}
 		}
 	}
+}
+
+uint32_t* ScaleFilter::ApplyFilter(uint32_t *inputArgbBuffer, uint32_t width, uint32_t height, double scanlineIntensity, VideoFilterThreadPool* threadPool)
+{
+	UpdateOutputBuffer(width, height);
+
+	_stripeBuffers.resize(VideoFilterThreadPool::GetStripeCount(threadPool, height));
+	VideoFilterThreadPool::RunStripes(threadPool, height, ScaleFilter::StripeMargin, [=](const VideoFilterStripe &stripe) {
+		ApplyFilter(inputArgbBuffer, scanlineIntensity, stripe);
+	});
 
 	return _outputBuffer;
 }
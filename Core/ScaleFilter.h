@@ -1,19 +1,29 @@
 #pragma once
 
 #include "stdafx.h"
+#include <mutex>
 #include "DefaultVideoFilter.h"
 
+class VideoFilterThreadPool;
+struct VideoFilterStripe;
+
 class ScaleFilter
 {
 private:
-	static bool _hqxInitDone;
+	//Stripes are processed with this many extra rows above/below them (the filters read up to 2 rows away)
+	static constexpr uint32_t StripeMargin = 2;
+
+	static std::once_flag _hqxInitFlag;
 	uint32_t _filterScale;
 	ScaleFilterType _scaleFilterType;
 	uint32_t *_outputBuffer = nullptr;
 	uint32_t _width = 0;
 	uint32_t _height = 0;
+	vector<vector<uint32_t>> _stripeBuffers;
 
-	void ApplyPrescaleFilter(uint32_t *inputArgbBuffer);
+	void ApplyPrescaleFilter(uint32_t *inputArgbBuffer, uint32_t yFirst, uint32_t yLast);
+	void ScaleImage(uint32_t *inputArgbBuffer, uint32_t *outputBuffer, uint32_t width, uint32_t height);
+	void ApplyFilter(uint32_t *inputArgbBuffer, double scanlineIntensity, const VideoFilterStripe &stripe);
 	void UpdateOutputBuffer(uint32_t width, uint32_t height);
 
 public:
@@ -21,7 +31,7 @@ public:
 	~ScaleFilter();
 
 	uint32_t GetScale();
-	uint32_t* ApplyFilter(uint32_t *inputArgbBuffer, uint32_t width, uint32_t height, double scanlineIntensity);
+	uint32_t* ApplyFilter(uint32_t *inputArgbBuffer, uint32_t width, uint32_t height, double scanlineIntensity, VideoFilterThreadPool* threadPool = nullptr);
 	FrameInfo GetFrameInfo(FrameInfo baseFrameInfo);
 
 	static shared_ptr<ScaleFilter> GetScaleFilter(VideoFilterType filter);
@@ -10,6 +10,8 @@ enum class EmulationFlags
 	MaximumSpeed = 0x04,
 	InBackground = 0x08,
 	GameboyMode = 0x10,
+	NoVideo = 0x20,
+	NoFrontendOutput = 0x40,
 };
 
 enum class ScaleFilterType
@@ -83,6 +85,7 @@ struct VideoConfig
 	bool HideBgLayer3 = false;
 	bool HideSprites = false;
 	bool DisableFrameSkipping = false;
+	bool UsePpuRenderThread = false;
 
 	double Brightness = 0;
 	double Contrast = 0;
@@ -97,6 +100,7 @@ struct VideoConfig
 	double NtscResolution = 0;
 	double NtscSharpness = 0;
 	bool NtscMergeFields = false;
+	bool NtscForceLowRes = false;
 
 	uint32_t OverscanLeft = 0;
 	uint32_t OverscanRight = 0;
@@ -110,6 +114,14 @@ struct VideoConfig
 	uint32_t FullscreenResHeight = 0;
 };
 
+enum class AudioResampler
+{
+	Hermite = 0,
+	SincFast = 1,
+	SincBalanced = 2,
+	SincHigh = 3,
+};
+
 struct AudioConfig
 {
 	const char* AudioDevice = nullptr;
@@ -121,6 +133,7 @@ struct AudioConfig
 	uint32_t AudioLatency = 60;
 
 	bool EnableCubicInterpolation  = true;
+	AudioResampler Resampler = AudioResampler::Hermite;
 
 	bool MuteSoundInBackground = false;
 	bool ReduceSoundInBackground = true;
@@ -295,6 +308,7 @@ struct EmulationConfig
 	ConsoleRegion Region = ConsoleRegion::Auto;
 
 	uint32_t RunAheadFrames = 0;
+	bool RunAheadSecondInstance = false;
 
 	bool EnableRandomPowerOnState = false;
 	bool EnableStrictBoardMappings = false;
@@ -10,6 +10,7 @@
 #include "Msu1.h"
 #include "BaseCartridge.h"
 #include "SuperGameboy.h"
+#include "PerfCounters.h"
 #include "../Utilities/Equalizer.h"
 
 SoundMixer::SoundMixer(Console *console)
@@ -52,6 +53,7 @@ void SoundMixer::StopAudio(bool clearBuffer)
 
 void SoundMixer::PlayAudioBuffer(int16_t* samples, uint32_t sampleCount, uint32_t sourceRate)
 {
+	PerfCounterScope perfScope(_console->GetPerfCounters(), PerfCounterType::SoundMixer);
 	AudioConfig cfg = _console->GetSettings()->GetAudioConfig();
 
 	if(cfg.EnableEqualizer) {
@@ -6,6 +6,7 @@
 #include "SoundMixer.h"
 #include "VideoRenderer.h"
 #include "../Utilities/HermiteResampler.h"
+#include "../Utilities/SincResampler.h"
 
 SoundResampler::SoundResampler(Console *console)
 {
@@ -70,8 +71,30 @@ double SoundResampler::GetTargetRateAdjustment()
 	return _rateAdjustment;
 }
 
+void SoundResampler::UpdateResamplerType(AudioResampler resamplerType)
+{
+	if(resamplerType == _resamplerType) {
+		return;
+	}
+
+	_resamplerType = resamplerType;
+	switch(resamplerType) {
+		default:
+		case AudioResampler::Hermite: _resampler.Reset(); break;
+		case AudioResampler::SincFast: _sincResampler.SetTapCount(8); break;
+		case AudioResampler::SincBalanced: _sincResampler.SetTapCount(16); break;
+		case AudioResampler::SincHigh: _sincResampler.SetTapCount(32); break;
+	}
+	_sincResampler.Reset();
+
+	//Force the newly selected resampler to be given the current sample rates
+	_previousTargetRate = 0;
+}
+
 void SoundResampler::UpdateTargetSampleRate(uint32_t sourceRate, uint32_t sampleRate)
 {
+	UpdateResamplerType(_console->GetSettings()->GetAudioConfig().Resampler);
+
 	double spcSampleRate = sourceRate;
 	if(_console->GetSettings()->GetVideoConfig().IntegerFpsMode) {
 		//Adjust sample rate when running at 60.0 fps instead of 60.1
@@ -86,12 +109,20 @@ void SoundResampler::UpdateTargetSampleRate(uint32_t sourceRate, uint32_t sample
 	if(targetRate != _previousTargetRate || spcSampleRate != _prevSpcSampleRate) {
 		_previousTargetRate = targetRate;
 		_prevSpcSampleRate = spcSampleRate;
-		_resampler.SetSampleRates(spcSampleRate, targetRate);
+		if(_resamplerType == AudioResampler::Hermite) {
+			_resampler.SetSampleRates(spcSampleRate, targetRate);
+		} else {
+			_sincResampler.SetSampleRates(spcSampleRate, targetRate);
+		}
 	}
 }
 
 uint32_t SoundResampler::Resample(int16_t *inSamples, uint32_t sampleCount, uint32_t sourceRate, uint32_t sampleRate, int16_t *outSamples)
 {
 	UpdateTargetSampleRate(sourceRate, sampleRate);
-	return _resampler.Resample(inSamples, sampleCount, outSamples);
+	if(_resamplerType == AudioResampler::Hermite) {
+		return _resampler.Resample(inSamples, sampleCount, outSamples);
+	} else {
+		return _sincResampler.Resample(inSamples, sampleCount, outSamples);
+	}
 }
\ No newline at end of file
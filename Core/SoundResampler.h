@@ -1,6 +1,8 @@
 #pragma once
 #include "stdafx.h"
 #include "../Utilities/HermiteResampler.h"
+#include "../Utilities/SincResampler.h"
+#include "SettingTypes.h"
 
 class Console;
 
@@ -14,9 +16,12 @@ private:
 	double _prevSpcSampleRate = 0;
 	int32_t _underTarget = 0;
 
+	AudioResampler _resamplerType = AudioResampler::Hermite;
 	HermiteResampler _resampler;
+	SincResampler _sincResampler;
 
 	double GetTargetRateAdjustment();
+	void UpdateResamplerType(AudioResampler resamplerType);
 	void UpdateTargetSampleRate(uint32_t sourceRate, uint32_t sampleRate);
 
 public:
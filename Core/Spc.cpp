@@ -5,6 +5,7 @@
 #include "SoundMixer.h"
 #include "EmuSettings.h"
 #include "SpcFileData.h"
+#include "PerfCounters.h"
 #ifndef DUMMYSPC
 #include "SPC_DSP.h"
 #else
@@ -86,6 +87,7 @@ void Spc::Reset()
 	_operandA = 0;
 	_operandB = 0;
 
+	RunDsp(true);
 	_dsp->soft_reset();
 	_dsp->set_output(_soundBuffer, Spc::SampleBufferSize >> 1);
 }
@@ -148,7 +150,11 @@ void Spc::IncCycleCount(int32_t addr)
 
 	_state.Cycle += cpuWait[speedSelect];
 #ifndef DUMMYSPC
-	_dsp->run();
+	_pendingDspClocks++;
+	bool dspAccess = addr >= 0 && (addr == 0xF3 || _dspRamPages[addr >> 8]);
+	if(dspAccess || _pendingDspClocks >= _dspBatchLimit) {
+		RunDsp(dspAccess);
+	}
 #endif
 
 	uint8_t timerInc = timerMultiplier[speedSelect];
@@ -157,6 +163,26 @@ void Spc::IncCycleCount(int32_t addr)
 	_state.Timer2.Run(timerInc);
 }
 
+void Spc::RunDsp(bool stateChanging)
+{
+#ifndef DUMMYSPC
+	if(_pendingDspClocks > 0) {
+		_dsp->run(_pendingDspClocks);
+		_pendingDspClocks = 0;
+	}
+
+	if(stateChanging || _console->IsDebugging()) {
+		//Run the DSP on the next cycle (after the access is done), and find which pages it uses again at that point
+		//The DSP always runs 1 cycle at a time when debugging, to keep its memory accesses in sync with the SPC's
+		_dspBatchLimit = 1;
+	} else {
+		memset(_dspRamPages, 0, sizeof(_dspRamPages));
+		_dsp->markRamPages(_dspRamPages, Spc::DspBatchSampleCount);
+		_dspBatchLimit = Spc::DspBatchSampleCount * 32;
+	}
+#endif
+}
+
 uint8_t Spc::DebugRead(uint16_t addr)
 {
 	if(addr >= 0xFFC0 && _state.RomEnabled) {
@@ -168,7 +194,10 @@ uint8_t Spc::DebugRead(uint16_t addr)
 		case 0xF1: return 0;
 
 		case 0xF2: return _state.DspReg;
-		case 0xF3: return _dsp->read(_state.DspReg & 0x7F);
+		case 0xF3:
+			//Run the batched DSP clocks first (like a regular read), otherwise ENDX/ENVX/OUTX could be out of date
+			RunDsp(true);
+			return _dsp->read(_state.DspReg & 0x7F);
 
 		case 0xF4: return _state.CpuRegs[0];
 		case 0xF5: return _state.CpuRegs[1];
@@ -352,6 +381,12 @@ void Spc::Run()
 	}
 
 	uint64_t targetCycle = (uint64_t)(_memoryManager->GetMasterClock() * _clockRatio);
+	if(_state.Cycle >= targetCycle) {
+		//Already caught up (e.g consecutive port accesses), avoid reading the clock for the perf counters
+		return;
+	}
+
+	PerfCounterScope perfScope(_console->GetPerfCounters(), PerfCounterType::Spc);
 	while(_state.Cycle < targetCycle) {
 		ProcessCycle();
 	}
@@ -374,6 +409,12 @@ void Spc::ProcessEndFrame()
 
 	UpdateClockRatio();
 
+	{
+		//The DSP clocks batched since the last SPC access are part of the SPC's time
+		PerfCounterScope perfScope(_console->GetPerfCounters(), PerfCounterType::Spc);
+		RunDsp(true);
+	}
+
 	int sampleCount = _dsp->sample_count();
 	if(sampleCount != 0) {
 		_console->GetSoundMixer()->PlayAudioBuffer(_soundBuffer, sampleCount / 2, Spc::SpcSampleRate);
@@ -388,6 +429,8 @@ SpcState Spc::GetState()
 
 DspState Spc::GetDspState()
 {
+	RunDsp(true);
+
 	DspState state;
 	_dsp->copyRegs(state.Regs);
 	return state;
@@ -432,6 +475,11 @@ uint8_t* Spc::GetSpcRom()
 
 void Spc::Serialize(Serializer &s)
 {
+	if(s.IsSaving()) {
+		//Catch up the DSP before saving the RAM (it can write to the echo buffer)
+		RunDsp(true);
+	}
+
 	s.Stream(_state.A, _state.Cycle, _state.PC, _state.PS, _state.SP, _state.X, _state.Y);
 	s.Stream(_state.CpuRegs[0], _state.CpuRegs[1], _state.CpuRegs[2], _state.CpuRegs[3]);
 	s.Stream(_state.OutputReg[0], _state.OutputReg[1], _state.OutputReg[2], _state.OutputReg[3]);
@@ -468,6 +516,9 @@ void Spc::Serialize(Serializer &s)
 		});
 
 		_dsp->set_output(_soundBuffer, Spc::SampleBufferSize >> 1);
+
+		_pendingDspClocks = 0;
+		_dspBatchLimit = 1;
 	}
 
 	s.Stream(_operandA, _operandB, _tmp1, _tmp2, _tmp3, _opCode, _opStep, _opSubStep, _enabled, _state.TimersDisabled);
@@ -553,6 +604,7 @@ uint16_t Spc::GetDirectAddress(uint8_t offset)
 
 void Spc::LoadSpcFile(SpcFileData* data)
 {
+	RunDsp(true);
 	memcpy(_ram, data->SpcRam, Spc::SpcRamSize);
 
 	_dsp->load(data->DspRegs);
@@ -28,6 +28,7 @@ public:
 private:
 	static constexpr int SampleBufferSize = 0x20000;
 	static constexpr uint16_t ResetVector = 0xFFFE;
+	static constexpr uint32_t DspBatchSampleCount = 32;
 
 	Console* _console;
 	MemoryManager* _memoryManager;
@@ -47,6 +48,12 @@ private:
 
 	bool _enabled;
 
+	//The DSP is only run when its state can be observed or altered by the SPC (DSP register access,
+	//or access to a RAM page the DSP could use while generating the next DspBatchSampleCount samples)
+	uint32_t _pendingDspClocks = 0;
+	uint32_t _dspBatchLimit = 1;
+	uint8_t _dspRamPages[256] = {};
+
 	SpcState _state;
 	uint8_t* _ram;
 	uint8_t _spcBios[64] {
@@ -277,6 +284,7 @@ private:
 	uint8_t ReadOperandByte();
 
 	void IncCycleCount(int32_t addr);
+	void RunDsp(bool stateChanging);
 	void EndOp();
 	void EndAddr();
 	void ProcessCycle();
@@ -14,7 +14,6 @@
 #include "NecDspTypes.h"
 #include "../Utilities/HexUtilities.h"
 
-string TraceLogger::_executionTrace = "";
 
 TraceLogger::TraceLogger(Debugger* debugger, shared_ptr<Console> console)
 {
@@ -598,11 +597,11 @@ void TraceLogger::Clear()
 	_logCount = 0;
 }
 
-const char* TraceLogger::GetExecutionTrace(uint32_t lineCount)
+string TraceLogger::GetExecutionTrace(uint32_t lineCount)
 {
 	int startPos;
 
-	_executionTrace.clear();
+	string executionTrace;
 	{
 		auto lock = _lock.AcquireSafe();
 		lineCount = std::min(lineCount, _logCount);
@@ -637,19 +636,19 @@ const char* TraceLogger::GetExecutionTrace(uint32_t lineCount)
 
 			DebugState &state = _stateCacheCopy[index];
 			switch(cpuType) {
-				case CpuType::Cpu: _executionTrace += "\x2\x1" + HexUtilities::ToHex24((state.Cpu.K << 16) | state.Cpu.PC) + "\x1"; break;
-				case CpuType::Spc: _executionTrace += "\x3\x1" + HexUtilities::ToHex(state.Spc.PC) + "\x1"; break;
-				case CpuType::NecDsp: _executionTrace += "\x4\x1" + HexUtilities::ToHex(state.NecDsp.PC) + "\x1"; break;
-				case CpuType::Sa1: _executionTrace += "\x4\x1" + HexUtilities::ToHex24((state.Sa1.Cpu.K << 16) | state.Sa1.Cpu.PC) + "\x1"; break;
-				case CpuType::Gsu: _executionTrace += "\x4\x1" + HexUtilities::ToHex24((state.Gsu.ProgramBank << 16) | state.Gsu.R[15]) + "\x1"; break;
-				case CpuType::Cx4: _executionTrace += "\x4\x1" + HexUtilities::ToHex24((state.Cx4.Cache.Address[state.Cx4.Cache.Page] + (state.Cx4.PC * 2)) & 0xFFFFFF) + "\x1"; break;
-				case CpuType::Gameboy: _executionTrace += "\x4\x1" + HexUtilities::ToHex(state.Gameboy.Cpu.PC) + "\x1"; break;
+				case CpuType::Cpu: executionTrace += "\x2\x1" + HexUtilities::ToHex24((state.Cpu.K << 16) | state.Cpu.PC) + "\x1"; break;
+				case CpuType::Spc: executionTrace += "\x3\x1" + HexUtilities::ToHex(state.Spc.PC) + "\x1"; break;
+				case CpuType::NecDsp: executionTrace += "\x4\x1" + HexUtilities::ToHex(state.NecDsp.PC) + "\x1"; break;
+				case CpuType::Sa1: executionTrace += "\x4\x1" + HexUtilities::ToHex24((state.Sa1.Cpu.K << 16) | state.Sa1.Cpu.PC) + "\x1"; break;
+				case CpuType::Gsu: executionTrace += "\x4\x1" + HexUtilities::ToHex24((state.Gsu.ProgramBank << 16) | state.Gsu.R[15]) + "\x1"; break;
+				case CpuType::Cx4: executionTrace += "\x4\x1" + HexUtilities::ToHex24((state.Cx4.Cache.Address[state.Cx4.Cache.Page] + (state.Cx4.PC * 2)) & 0xFFFFFF) + "\x1"; break;
+				case CpuType::Gameboy: executionTrace += "\x4\x1" + HexUtilities::ToHex(state.Gameboy.Cpu.PC) + "\x1"; break;
 			}
 
 			string byteCode;
 			_disassemblyCacheCopy[index].GetByteCode(byteCode);
-			_executionTrace += byteCode + "\x1";
-			GetTraceRow(_executionTrace, cpuType, _disassemblyCacheCopy[index], _stateCacheCopy[index]);
+			executionTrace += byteCode + "\x1";
+			GetTraceRow(executionTrace, cpuType, _disassemblyCacheCopy[index], _stateCacheCopy[index]);
 
 			lineCount--;
 			if(lineCount == 0) {
@@ -657,5 +656,5 @@ const char* TraceLogger::GetExecutionTrace(uint32_t lineCount)
 			}
 		}
 	}
-	return _executionTrace.c_str();
+	return executionTrace;
 }
\ No newline at end of file
@@ -78,9 +78,6 @@ class TraceLogger
 private:
 	static constexpr int ExecutionLogSize = 30000;
 
-	//Must be static to be thread-safe when switching game
-	static string _executionTrace;
-
 	TraceLoggerOptions _options;
 	string _outputFilepath;
 	string _outputBuffer;
@@ -153,5 +150,5 @@ public:
 
 	void LogExtraInfo(const char *log, uint32_t cycleCount);
 
-	const char* GetExecutionTrace(uint32_t lineCount);
+	string GetExecutionTrace(uint32_t lineCount);
 };
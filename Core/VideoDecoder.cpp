@@ -10,9 +10,11 @@
 #include "SettingTypes.h"
 #include "NtscFilter.h"
 #include "ScaleFilter.h"
+#include "VideoFilterThreadPool.h"
 #include "Ppu.h"
 #include "DebugHud.h"
 #include "InputHud.h"
+#include "PerfCounters.h"
 
 VideoDecoder::VideoDecoder(shared_ptr<Console> console)
 {
@@ -64,6 +66,15 @@ ScreenSize VideoDecoder::GetScreenSize(bool ignoreScale)
 	return size;
 }
 
+VideoFilterThreadPool* VideoDecoder::GetFilterThreadPool()
+{
+	if(!_filterThreadPool) {
+		//Only created once a filter that uses it is selected
+		_filterThreadPool.reset(new VideoFilterThreadPool());
+	}
+	return _filterThreadPool.get();
+}
+
 void VideoDecoder::UpdateVideoFilter()
 {
 	VideoFilterType newFilter = _console->GetSettings()->GetVideoConfig().VideoFilter;
@@ -75,7 +86,7 @@ void VideoDecoder::UpdateVideoFilter()
 
 		switch(_videoFilterType) {
 			case VideoFilterType::None: break;
-			case VideoFilterType::NTSC: _videoFilter.reset(new NtscFilter(_console)); break;
+			case VideoFilterType::NTSC: _videoFilter.reset(new NtscFilter(_console, GetFilterThreadPool())); break;
 			default: _scaleFilter = ScaleFilter::GetScaleFilter(_videoFilterType); break;
 		}
 	}
@@ -83,6 +94,7 @@ void VideoDecoder::UpdateVideoFilter()
 
 void VideoDecoder::DecodeFrame(bool forRewind)
 {
+	PerfCounterScope perfScope(_console->GetPerfCounters(), PerfCounterType::VideoDecoder);
 	UpdateVideoFilter();
 
 	_videoFilter->SetBaseFrameInfo(_baseFrameInfo);
@@ -95,7 +107,7 @@ void VideoDecoder::DecodeFrame(bool forRewind)
 	_console->GetDebugHud()->Draw(outputBuffer, _videoFilter->GetOverscan(), frameInfo.Width, _frameNumber);
 
 	if(_scaleFilter) {
-		outputBuffer = _scaleFilter->ApplyFilter(outputBuffer, frameInfo.Width, frameInfo.Height, _console->GetSettings()->GetVideoConfig().ScanlineIntensity);
+		outputBuffer = _scaleFilter->ApplyFilter(outputBuffer, frameInfo.Width, frameInfo.Height, _console->GetSettings()->GetVideoConfig().ScanlineIntensity, GetFilterThreadPool());
 		frameInfo = _scaleFilter->GetFrameInfo(frameInfo);
 	}
 
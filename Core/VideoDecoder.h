@@ -6,6 +6,7 @@
 
 class BaseVideoFilter;
 class ScaleFilter;
+class VideoFilterThreadPool;
 //class RotateFilter;
 class IRenderingDevice;
 class InputHud;
@@ -34,10 +35,12 @@ private:
 	FrameInfo _lastFrameInfo;
 
 	VideoFilterType _videoFilterType = VideoFilterType::None;
+	unique_ptr<VideoFilterThreadPool> _filterThreadPool;
 	unique_ptr<BaseVideoFilter> _videoFilter;
 	shared_ptr<ScaleFilter> _scaleFilter;
 	//shared_ptr<RotateFilter> _rotateFilter;
 
+	VideoFilterThreadPool* GetFilterThreadPool();
 	void UpdateVideoFilter();
 
 	void DecodeThread();
@@ -0,0 +1,116 @@
+#include "stdafx.h"
+#include "VideoFilterThreadPool.h"
+
+VideoFilterThreadPool::VideoFilterThreadPool(uint32_t threadCount)
+{
+	if(threadCount == 0) {
+		threadCount = std::min(VideoFilterThreadPool::MaxThreadCount, std::max<uint32_t>(1, std::thread::hardware_concurrency()));
+	}
+
+	_threadCount = threadCount;
+	_nextJob = 0;
+	_pendingWorkers = 0;
+	_stopFlag = false;
+
+	//The calling thread acts as worker #0
+	for(uint32_t i = 1; i < threadCount; i++) {
+		_startSignals.push_back(unique_ptr<AutoResetEvent>(new AutoResetEvent()));
+	}
+	for(uint32_t i = 1; i < threadCount; i++) {
+		_workers.push_back(unique_ptr<std::thread>(new std::thread(&VideoFilterThreadPool::WorkerThread, this, i)));
+	}
+}
+
+VideoFilterThreadPool::~VideoFilterThreadPool()
+{
+	_stopFlag = true;
+	for(unique_ptr<AutoResetEvent> &signal : _startSignals) {
+		signal->Signal();
+	}
+	for(unique_ptr<std::thread> &worker : _workers) {
+		worker->join();
+	}
+}
+
+uint32_t VideoFilterThreadPool::GetThreadCount()
+{
+	return _threadCount;
+}
+
+void VideoFilterThreadPool::WorkerThread(uint32_t index)
+{
+	while(true) {
+		_startSignals[index - 1]->Wait();
+		if(_stopFlag) {
+			break;
+		}
+
+		ProcessJobs();
+
+		if(--_pendingWorkers == 0) {
+			_jobsDone.Signal();
+		}
+	}
+}
+
+void VideoFilterThreadPool::ProcessJobs()
+{
+	while(true) {
+		uint32_t jobIndex = _nextJob++;
+		if(jobIndex >= _jobCount) {
+			break;
+		}
+		(*_job)(jobIndex);
+	}
+}
+
+void VideoFilterThreadPool::Run(uint32_t jobCount, const std::function<void(uint32_t)> &job)
+{
+	uint32_t workerCount = std::min(_threadCount, jobCount);
+
+	_job = &job;
+	_jobCount = jobCount;
+	_nextJob = 0;
+
+	if(workerCount > 1) {
+		_pendingWorkers = workerCount - 1;
+		for(uint32_t i = 1; i < workerCount; i++) {
+			_startSignals[i - 1]->Signal();
+		}
+	}
+
+	ProcessJobs();
+
+	if(workerCount > 1) {
+		_jobsDone.Wait();
+	}
+	_job = nullptr;
+}
+
+uint32_t VideoFilterThreadPool::GetStripeCount(VideoFilterThreadPool* pool, uint32_t height)
+{
+	if(!pool) {
+		return 1;
+	}
+	return std::max<uint32_t>(1, std::min(pool->GetThreadCount(), height / VideoFilterThreadPool::MinStripeHeight));
+}
+
+void VideoFilterThreadPool::RunStripes(VideoFilterThreadPool* pool, uint32_t height, uint32_t margin, const std::function<void(const VideoFilterStripe&)> &stripe)
+{
+	uint32_t stripeCount = GetStripeCount(pool, height);
+	auto runStripe = [=, &stripe](uint32_t i) {
+		VideoFilterStripe info;
+		info.Index = i;
+		info.FirstRow = height * i / stripeCount;
+		info.LastRow = height * (i + 1) / stripeCount;
+		info.Top = info.FirstRow > margin ? info.FirstRow - margin : 0;
+		info.Bottom = std::min(height, info.LastRow + margin);
+		stripe(info);
+	};
+
+	if(stripeCount > 1) {
+		pool->Run(stripeCount, runStripe);
+	} else {
+		runStripe(0);
+	}
+}
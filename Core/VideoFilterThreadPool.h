@@ -0,0 +1,57 @@
+#pragma once
+#include "stdafx.h"
+#include <functional>
+#include "../Utilities/AutoResetEvent.h"
+
+struct VideoFilterStripe
+{
+	uint32_t Index;
+
+	//Rows the stripe outputs (LastRow is excluded)
+	uint32_t FirstRow;
+	uint32_t LastRow;
+
+	//Rows the stripe may read from: its own rows plus the requested margin above/below them, clipped to the frame
+	uint32_t Top;
+	uint32_t Bottom;
+};
+
+//Persistent worker threads used by the video filters to process a frame in parallel (e.g one horizontal stripe per job)
+//The calling thread also processes jobs, so a pool with a single thread runs everything on the calling thread.
+class VideoFilterThreadPool
+{
+private:
+	static constexpr uint32_t MaxThreadCount = 8;
+	//Smaller stripes aren't worth the cost of waking up another thread
+	static constexpr uint32_t MinStripeHeight = 16;
+
+	vector<unique_ptr<std::thread>> _workers;
+	vector<unique_ptr<AutoResetEvent>> _startSignals;
+	uint32_t _threadCount = 0;
+
+	const std::function<void(uint32_t)>* _job = nullptr;
+	uint32_t _jobCount = 0;
+	atomic<uint32_t> _nextJob;
+	atomic<uint32_t> _pendingWorkers;
+	AutoResetEvent _jobsDone;
+	atomic<bool> _stopFlag;
+
+	void WorkerThread(uint32_t index);
+	void ProcessJobs();
+
+public:
+	//threadCount includes the calling thread, 0 uses one thread per host core (up to 8)
+	VideoFilterThreadPool(uint32_t threadCount = 0);
+	~VideoFilterThreadPool();
+
+	uint32_t GetThreadCount();
+
+	//Runs job(0) to job(jobCount - 1) on the pool's threads and returns once they are all done
+	void Run(uint32_t jobCount, const std::function<void(uint32_t)> &job);
+
+	//Number of stripes a frame of the given height is split into by RunStripes (always 1 without a thread pool)
+	static uint32_t GetStripeCount(VideoFilterThreadPool* pool, uint32_t height);
+
+	//Splits the frame's rows into horizontal stripes and runs stripe() for each of them, in parallel when a pool is given
+	static void RunStripes(VideoFilterThreadPool* pool, uint32_t height, uint32_t margin, const std::function<void(const VideoFilterStripe&)> &stripe);
+};
@@ -21,6 +21,9 @@
 extern shared_ptr<Console> _console;
 static string _logString;
 
+//Kept here rather than in the TraceLogger so the returned pointer stays valid when switching game
+static string _executionTrace;
+
 shared_ptr<Debugger> GetDebugger()
 {
 	return _console->GetDebugger();
@@ -58,7 +61,11 @@ extern "C"
 	DllExport void __stdcall StartTraceLogger(char* filename) { GetDebugger()->GetTraceLogger()->StartLogging(filename); }
 	DllExport void __stdcall StopTraceLogger() { GetDebugger()->GetTraceLogger()->StopLogging(); }
 	DllExport void __stdcall ClearTraceLog() { GetDebugger()->GetTraceLogger()->Clear(); }
-	DllExport const char* GetExecutionTrace(uint32_t lineCount) { return GetDebugger()->GetTraceLogger()->GetExecutionTrace(lineCount); }
+	DllExport const char* GetExecutionTrace(uint32_t lineCount)
+	{
+		_executionTrace = GetDebugger()->GetTraceLogger()->GetExecutionTrace(lineCount);
+		return _executionTrace.c_str();
+	}
 
 	DllExport void __stdcall SetBreakpoints(Breakpoint breakpoints[], uint32_t length) { GetDebugger()->SetBreakpoints(breakpoints, length); }
 	DllExport void __stdcall GetBreakpoints(CpuType cpuType, Breakpoint* breakpoints, int& execs, int& reads, int& writes) { GetDebugger()->GetBreakpoints(cpuType, breakpoints, execs, reads, writes); }
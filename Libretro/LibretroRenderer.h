@@ -13,6 +13,11 @@ private:
 	retro_video_refresh_t _sendFrame = nullptr;
 	retro_environment_t _retroEnv = nullptr;
 	bool _skipMode = false;
+	bool _frameSent = false;
+	bool _canDupe = false;
+	vector<uint32_t> _lastFrame;
+	uint32_t _frameWidth = 0;
+	uint32_t _frameHeight = 0;
 	int32_t _previousHeight = -1;
 	int32_t _previousWidth = -1;
 
@@ -21,6 +26,9 @@ public:
 	{
 		_console = console;
 		_retroEnv = retroEnv;
+		if(!_retroEnv(RETRO_ENVIRONMENT_GET_CAN_DUPE, &_canDupe)) {
+			_canDupe = false;
+		}
 		_console->GetVideoRenderer()->RegisterRenderingDevice(this);
 	}
 
@@ -47,7 +55,31 @@ public:
 			}
 
 			_sendFrame(frameBuffer, width, height, sizeof(uint32_t) * width);
+			_frameSent = true;
+			_frameWidth = width;
+			_frameHeight = height;
+
+			if(!_canDupe && _console->GetSettings()->CheckFlag(EmulationFlags::NoVideo)) {
+				//The frontend can't dupe frames, keep a copy of the frame to send it again on the frames that aren't rendered
+				_lastFrame.assign((uint32_t*)frameBuffer, (uint32_t*)frameBuffer + width * height);
+			} else if(!_lastFrame.empty()) {
+				_lastFrame.clear();
+				_lastFrame.shrink_to_fit();
+			}
+		}
+	}
+
+	//Called at the end of retro_run - when no frame was sent (no-video mode), tells the frontend to keep showing the previous one
+	void EndFrame()
+	{
+		if(!_frameSent && !_skipMode && _sendFrame) {
+			if(_canDupe) {
+				_sendFrame(nullptr, _frameWidth, _frameHeight, sizeof(uint32_t) * _frameWidth);
+			} else if(!_lastFrame.empty()) {
+				_sendFrame(_lastFrame.data(), _frameWidth, _frameHeight, sizeof(uint32_t) * _frameWidth);
+			}
 		}
+		_frameSent = false;
 	}
 	
 	void GetSystemAudioVideoInfo(retro_system_av_info &info, int32_t maxWidth = 0, int32_t maxHeight = 0)
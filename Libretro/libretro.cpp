@@ -41,10 +41,13 @@ static std::unique_ptr<LibretroKeyManager> _keyManager;
 static std::unique_ptr<LibretroMessageManager> _messageManager;
 
 static constexpr const char* MesenNtscFilter = "mesen-s_ntsc_filter";
+static constexpr const char* MesenNtscForceLowRes = "mesen-s_ntsc_force_low_res";
 static constexpr const char* MesenRegion = "mesen-s_region";
 static constexpr const char* MesenAspectRatio = "mesen-s_aspect_ratio";
 static constexpr const char* MesenBlendHighRes = "mesen-s_blend_high_res";
 static constexpr const char* MesenCubicInterpolation = "mesen-s_cubic_interpolation";
+static constexpr const char* MesenPpuRenderThread = "mesen-s_ppu_render_thread";
+static constexpr const char* MesenNoVideo = "mesen-s_no_video";
 static constexpr const char* MesenOverscanVertical = "mesen-s_overscan_vertical";
 static constexpr const char* MesenOverscanHorizontal = "mesen-s_overscan_horizontal";
 static constexpr const char* MesenRamState = "mesen-s_ramstate";
@@ -114,6 +117,7 @@ extern "C" {
 
 		static constexpr struct retro_variable vars[] = {
 			{ MesenNtscFilter, "NTSC filter; Disabled|Composite (Blargg)|S-Video (Blargg)|RGB (Blargg)|Monochrome (Blargg)" },
+			{ MesenNtscForceLowRes, "NTSC filter on Hi-Res modes at 256 pixels; disabled|enabled" },
 			{ MesenRegion, "Region; Auto|NTSC|PAL" },
 			{ MesenGbModel, "Game Boy Model; Auto|Game Boy|Game Boy Color|Super Game Boy" },
 			{ MesenGbSgb2, "Use SGB2; enabled|disabled" },
@@ -122,6 +126,8 @@ extern "C" {
 			{ MesenAspectRatio, "Aspect Ratio; Auto|No Stretching|NTSC|PAL|4:3|16:9" },
 			{ MesenBlendHighRes, "Blend Hi-Res Modes; disabled|enabled" },
 			{ MesenCubicInterpolation, "Cubic Interpolation (Audio); disabled|enabled" },
+			{ MesenPpuRenderThread, "Render on a separate thread; disabled|enabled" },
+			{ MesenNoVideo, "Disable video output (headless); disabled|enabled" },
 			{ MesenOverclock, "Overclock; None|Low|Medium|High|Very High" },
 			{ MesenOverclockType, "Overclock Type; Before NMI|After NMI" },
 			{ MesenSuperFxOverclock, "Super FX Clock Speed; 100%|200%|300%|400%|500%|1000%" },
@@ -271,6 +277,11 @@ extern "C" {
 			}
 		}
 
+		if(readVariable(MesenNtscForceLowRes, var)) {
+			string value = string(var.value);
+			video.NtscForceLowRes = (value == "enabled");
+		}
+
 		bool beforeNmi = true;
 		if(readVariable(MesenOverclockType, var)) {
 			string value = string(var.value);
@@ -389,6 +400,21 @@ extern "C" {
 			string value = string(var.value);
 			video.BlendHighResolutionModes = (value == "enabled");
 		}
+
+		if(readVariable(MesenPpuRenderThread, var)) {
+			string value = string(var.value);
+			video.UsePpuRenderThread = (value == "enabled");
+		}
+
+		if(readVariable(MesenNoVideo, var)) {
+			string value = string(var.value);
+			bool noVideo = value == "enabled";
+			if(noVideo && !settings->CheckFlag(EmulationFlags::NoVideo)) {
+				//Render the first frame, it is sent again on the frames that follow when the frontend can't dupe frames
+				_console->RenderNextFrame();
+			}
+			settings->SetFlagState(EmulationFlags::NoVideo, noVideo);
+		}
 		
 		if(readVariable(MesenCubicInterpolation, var)) {
 			string value = string(var.value);
@@ -472,6 +498,7 @@ extern "C" {
 		_console->GetSettings()->SetEmulationConfig(cfg);
 
 		_console->RunSingleFrame();
+		_renderer->EndFrame();
 
 		if(updated) {
 			//Update geometry after running the frame, in case the console's region changed (affects "auto" aspect ratio)
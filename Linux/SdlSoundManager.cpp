@@ -31,12 +31,6 @@ void SdlSoundManager::Release()
 		Stop();
 		SDL_CloseAudioDevice(_audioDeviceID);
 	}
-
-	if(_buffer) {
-		delete[] _buffer;
-		_buffer = nullptr;
-		_bufferSize = 0;
-	}
 }
 
 bool SdlSoundManager::InitializeAudio(uint32_t sampleRate, bool isStereo)
@@ -54,16 +48,22 @@ bool SdlSoundManager::InitializeAudio(uint32_t sampleRate, bool isStereo)
 
 	int bytesPerSample = 2 * (isStereo ? 2 : 1);
 	int32_t requestedByteLatency = (int32_t)((float)(sampleRate * _previousLatency) / 1000.0f * bytesPerSample);
-	_bufferSize = (int32_t)std::ceil((double)requestedByteLatency * 2 / 0x10000) * 0x10000;
-	_buffer = new uint8_t[_bufferSize];
-	memset(_buffer, 0, _bufferSize);
+	_buffer.Reset((uint32_t)std::ceil((double)requestedByteLatency * 2 / 0x10000) * 0x10000);
+	_bufferSize = _buffer.GetSize();
+
+	//Use a callback period of at most half the requested latency (e.g 256 samples for 20ms and 512 samples for 30ms at 44.1kHz)
+	//otherwise each callback drains more audio than the buffer is meant to hold, which causes underruns at low latencies
+	uint16_t callbackSamples = 1024;
+	while(callbackSamples > 256 && callbackSamples > sampleRate * _previousLatency / 2000) {
+		callbackSamples >>= 1;
+	}
 
 	SDL_AudioSpec audioSpec;
 	SDL_memset(&audioSpec, 0, sizeof(audioSpec));
 	audioSpec.freq = sampleRate;
 	audioSpec.format = AUDIO_S16SYS; //16-bit samples
 	audioSpec.channels = isStereo ? 2 : 1;
-	audioSpec.samples = 1024;
+	audioSpec.samples = callbackSamples;
 	audioSpec.callback = &SdlSoundManager::FillAudioBuffer;
 	audioSpec.userdata = this;
 
@@ -75,9 +75,6 @@ bool SdlSoundManager::InitializeAudio(uint32_t sampleRate, bool isStereo)
 		_audioDeviceID = SDL_OpenAudioDevice(nullptr, isCapture, &audioSpec, &obtainedSpec, 0);
 	}
 
-	_writePosition = 0;
-	_readPosition = 0;
-
 	_needReset = false;
 
 	return _audioDeviceID != 0;
@@ -119,33 +116,20 @@ void SdlSoundManager::SetAudioDevice(string deviceName)
 
 void SdlSoundManager::ReadFromBuffer(uint8_t* output, uint32_t len)
 {
-	if(_readPosition + len < _bufferSize) {
-		memcpy(output, _buffer+_readPosition, len);
-		_readPosition += len;
-	} else {
-		int remainingBytes = (_bufferSize - _readPosition);
-		memcpy(output, _buffer+_readPosition, remainingBytes);
-		memcpy(output+remainingBytes, _buffer, len - remainingBytes);
-		_readPosition = len - remainingBytes;
-	}
-
-	if(_readPosition >= _writePosition && _readPosition - _writePosition < _bufferSize / 2) {
+	uint32_t bytesRead = _buffer.Read(output, len);
+	if(bytesRead < len) {
+		//Not enough audio was produced in time, play silence for the remainder instead of stale samples
+		memset(output + bytesRead, 0, len - bytesRead);
 		_bufferUnderrunEventCount++;
 	}
 }
 
 void SdlSoundManager::WriteToBuffer(uint8_t* input, uint32_t len)
 {
-	if(_writePosition + len < _bufferSize) {
-		memcpy(_buffer+_writePosition, input, len);
-		_writePosition += len;
-	} else {
-		int remainingBytes = _bufferSize - _writePosition;
-		memcpy(_buffer+_writePosition, input, remainingBytes);
-		memcpy(_buffer, ((uint8_t*)input)+remainingBytes, len - remainingBytes);
-		_writePosition = len - remainingBytes;
-	}
+	//When the buffer is full, the samples that don't fit are dropped (the latency check in ProcessEndOfFrame resets playback if this persists)
+	_buffer.Write(input, len);
 }
+
 void SdlSoundManager::PlayBuffer(int16_t *soundBuffer, uint32_t sampleCount, uint32_t sampleRate, bool isStereo)
 {
 	uint32_t bytesPerSample = 2 * (isStereo ? 2 : 1);
@@ -157,13 +141,8 @@ void SdlSoundManager::PlayBuffer(int16_t *soundBuffer, uint32_t sampleCount, uin
 
 	WriteToBuffer((uint8_t*)soundBuffer, sampleCount * bytesPerSample);
 
-	int32_t byteLatency = (int32_t)((float)(sampleRate * latency) / 1000.0f * bytesPerSample);
-	int32_t playWriteByteLatency = _writePosition - _readPosition;
-	if(playWriteByteLatency < 0) {
-		playWriteByteLatency = _bufferSize - _readPosition + _writePosition;
-	}
-
-	if(playWriteByteLatency > byteLatency) {
+	uint32_t byteLatency = (uint32_t)((float)(sampleRate * latency) / 1000.0f * bytesPerSample);
+	if(_buffer.GetUsedBytes() > byteLatency) {
 		//Start playing
 		SDL_PauseAudioDevice(_audioDeviceID, 0);
 	}
@@ -178,14 +157,16 @@ void SdlSoundManager::Stop()
 {
 	Pause();
 
-	_readPosition = 0;
-	_writePosition = 0;
+	//Make sure the audio callback isn't running while the buffer is reset
+	SDL_LockAudioDevice(_audioDeviceID);
+	_buffer.Reset(_bufferSize);
+	SDL_UnlockAudioDevice(_audioDeviceID);
 	ResetStats();
 }
 
 void SdlSoundManager::ProcessEndOfFrame()
 {
-	ProcessLatency(_readPosition, _writePosition);
+	ProcessLatency(_buffer.GetUsedBytes());
 
 	uint32_t emulationSpeed = _console->GetSettings()->GetEmulationSpeed();
 	if(_averageLatency > 0 && emulationSpeed <= 100 && emulationSpeed > 0 && std::abs(_averageLatency - _console->GetSettings()->GetAudioConfig().AudioLatency) > 50) {
@@ -1,6 +1,7 @@
 ﻿#pragma once
 #include <SDL2/SDL.h>
 #include "../Core/BaseSoundManager.h"
+#include "../Utilities/SpscRingBuffer.h"
 
 class Console;
 
@@ -27,7 +28,7 @@ private:
 	static void FillAudioBuffer(void *userData, uint8_t *stream, int len);
 
 	void ReadFromBuffer(uint8_t* output, uint32_t len);
-	void WriteToBuffer(uint8_t* output, uint32_t len);
+	void WriteToBuffer(uint8_t* input, uint32_t len);
 
 private:
 	shared_ptr<Console> _console;
@@ -37,7 +38,6 @@ private:
 
 	uint16_t _previousLatency = 0;
 
-	uint8_t* _buffer = nullptr;
-	uint32_t _writePosition = 0;
-	uint32_t _readPosition = 0;
+	//Written by the emulation thread, read by SDL's audio callback
+	SpscRingBuffer _buffer;
 };
@@ -19,6 +19,7 @@ namespace Mesen.GUI.Config
 		[MinMax(15, 300)] public UInt32 AudioLatency = 60;
 
 		[MarshalAs(UnmanagedType.I1)] public bool EnableCubicInterpolation = false;
+		public AudioResampler Resampler = AudioResampler.Hermite;
 
 		[MarshalAs(UnmanagedType.I1)] public bool MuteSoundInBackground = false;
 		[MarshalAs(UnmanagedType.I1)] public bool ReduceSoundInBackground = true;
@@ -52,4 +53,12 @@ namespace Mesen.GUI.Config
 			ConfigApi.SetAudioConfig(this);
 		}
 	}
+
+	public enum AudioResampler
+	{
+		Hermite = 0,
+		SincFast = 1,
+		SincBalanced = 2,
+		SincHigh = 3,
+	}
 }
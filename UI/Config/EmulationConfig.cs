@@ -17,6 +17,7 @@ namespace Mesen.GUI.Config
 		public ConsoleRegion Region = ConsoleRegion.Auto;
 		
 		[MinMax(0, 10)] public UInt32 RunAheadFrames = 0;
+		[MarshalAs(UnmanagedType.I1)] public bool RunAheadSecondInstance = false;
 
 		[MarshalAs(UnmanagedType.I1)] public bool EnableRandomPowerOnState = false;
 		[MarshalAs(UnmanagedType.I1)] public bool EnableStrictBoardMappings = false;
@@ -26,6 +26,7 @@ namespace Mesen.GUI.Config
 		[MarshalAs(UnmanagedType.I1)] public bool HideBgLayer3 = false;
 		[MarshalAs(UnmanagedType.I1)] public bool HideSprites = false;
 		[MarshalAs(UnmanagedType.I1)] public bool DisableFrameSkipping = false;
+		[MarshalAs(UnmanagedType.I1)] public bool UsePpuRenderThread = false;
 
 		[MinMax(-1, 1.0)] public double Brightness = 0;
 		[MinMax(-1, 1.0)] public double Contrast = 0;
@@ -40,6 +41,7 @@ namespace Mesen.GUI.Config
 		[MinMax(-1, 1.0)] public double NtscResolution = 0;
 		[MinMax(-1, 1.0)] public double NtscSharpness = 0;
 		[MarshalAs(UnmanagedType.I1)] public bool NtscMergeFields = false;
+		[MarshalAs(UnmanagedType.I1)] public bool NtscForceLowRes = false;
 
 		[MinMax(0, 100)] public UInt32 OverscanLeft = 0;
 		[MinMax(0, 100)] public UInt32 OverscanRight = 0;
@@ -77,6 +77,9 @@
 			this.tableLayoutPanel1 = new System.Windows.Forms.TableLayoutPanel();
 			this.chkDisableDynamicSampleRate = new Mesen.GUI.Controls.ctrlRiskyOption();
 			this.chkEnableCubicInterpolation = new System.Windows.Forms.CheckBox();
+			this.flpResampler = new System.Windows.Forms.FlowLayoutPanel();
+			this.lblResampler = new System.Windows.Forms.Label();
+			this.cboResampler = new System.Windows.Forms.ComboBox();
 			this.tabControl1.SuspendLayout();
 			this.tpgGeneral.SuspendLayout();
 			this.tableLayoutPanel2.SuspendLayout();
@@ -88,6 +91,7 @@
 			this.tlpEqualizer.SuspendLayout();
 			this.tpgAdvanced.SuspendLayout();
 			this.tableLayoutPanel1.SuspendLayout();
+			this.flpResampler.SuspendLayout();
 			this.SuspendLayout();
 			// 
 			// baseConfigPanel
@@ -894,10 +898,12 @@
 			this.tableLayoutPanel1.ColumnStyles.Add(new System.Windows.Forms.ColumnStyle(System.Windows.Forms.SizeType.Percent, 100F));
 			this.tableLayoutPanel1.Controls.Add(this.chkDisableDynamicSampleRate, 0, 1);
 			this.tableLayoutPanel1.Controls.Add(this.chkEnableCubicInterpolation, 0, 0);
+			this.tableLayoutPanel1.Controls.Add(this.flpResampler, 0, 2);
 			this.tableLayoutPanel1.Dock = System.Windows.Forms.DockStyle.Fill;
 			this.tableLayoutPanel1.Location = new System.Drawing.Point(3, 3);
 			this.tableLayoutPanel1.Name = "tableLayoutPanel1";
-			this.tableLayoutPanel1.RowCount = 3;
+			this.tableLayoutPanel1.RowCount = 4;
+			this.tableLayoutPanel1.RowStyles.Add(new System.Windows.Forms.RowStyle());
 			this.tableLayoutPanel1.RowStyles.Add(new System.Windows.Forms.RowStyle());
 			this.tableLayoutPanel1.RowStyles.Add(new System.Windows.Forms.RowStyle());
 			this.tableLayoutPanel1.RowStyles.Add(new System.Windows.Forms.RowStyle(System.Windows.Forms.SizeType.Percent, 100F));
@@ -923,6 +929,36 @@
 			this.chkEnableCubicInterpolation.Text = "Enable cubic interpolation";
 			this.chkEnableCubicInterpolation.UseVisualStyleBackColor = true;
 			// 
+			// flpResampler
+			// 
+			this.flpResampler.Controls.Add(this.lblResampler);
+			this.flpResampler.Controls.Add(this.cboResampler);
+			this.flpResampler.Dock = System.Windows.Forms.DockStyle.Fill;
+			this.flpResampler.Location = new System.Drawing.Point(0, 50);
+			this.flpResampler.Margin = new System.Windows.Forms.Padding(0);
+			this.flpResampler.Name = "flpResampler";
+			this.flpResampler.Size = new System.Drawing.Size(478, 27);
+			this.flpResampler.TabIndex = 7;
+			// 
+			// lblResampler
+			// 
+			this.lblResampler.Anchor = System.Windows.Forms.AnchorStyles.Left;
+			this.lblResampler.AutoSize = true;
+			this.lblResampler.Location = new System.Drawing.Point(3, 7);
+			this.lblResampler.Name = "lblResampler";
+			this.lblResampler.Size = new System.Drawing.Size(60, 13);
+			this.lblResampler.TabIndex = 0;
+			this.lblResampler.Text = "Resampler:";
+			// 
+			// cboResampler
+			// 
+			this.cboResampler.DropDownStyle = System.Windows.Forms.ComboBoxStyle.DropDownList;
+			this.cboResampler.FormattingEnabled = true;
+			this.cboResampler.Location = new System.Drawing.Point(69, 3);
+			this.cboResampler.Name = "cboResampler";
+			this.cboResampler.Size = new System.Drawing.Size(197, 21);
+			this.cboResampler.TabIndex = 1;
+			// 
 			// frmAudioConfig
 			// 
 			this.AutoScaleDimensions = new System.Drawing.SizeF(6F, 13F);
@@ -953,6 +989,8 @@
 			this.tpgAdvanced.ResumeLayout(false);
 			this.tableLayoutPanel1.ResumeLayout(false);
 			this.tableLayoutPanel1.PerformLayout();
+			this.flpResampler.ResumeLayout(false);
+			this.flpResampler.PerformLayout();
 			this.ResumeLayout(false);
 			this.PerformLayout();
 
@@ -1010,5 +1048,8 @@
 		private System.Windows.Forms.TableLayoutPanel tableLayoutPanel1;
 		private Controls.ctrlRiskyOption chkDisableDynamicSampleRate;
 	  private System.Windows.Forms.CheckBox chkEnableCubicInterpolation;
+		private System.Windows.Forms.FlowLayoutPanel flpResampler;
+		private System.Windows.Forms.Label lblResampler;
+		private System.Windows.Forms.ComboBox cboResampler;
    }
 }
\ No newline at end of file
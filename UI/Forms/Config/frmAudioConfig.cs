@@ -32,6 +32,7 @@ namespace Mesen.GUI.Forms.Config
 			AddBinding(nameof(AudioConfig.DisableDynamicSampleRate), chkDisableDynamicSampleRate);
 			
 			AddBinding(nameof(AudioConfig.EnableCubicInterpolation), chkEnableCubicInterpolation);
+			AddBinding(nameof(AudioConfig.Resampler), cboResampler);
 
 			AddBinding(nameof(AudioConfig.EnableEqualizer), chkEnableEqualizer);
 			AddBinding(nameof(AudioConfig.Band1Gain), trkBand1Gain);
@@ -35,6 +35,7 @@
 			this.nudRunAheadFrames = new Mesen.GUI.Controls.MesenNumericUpDown();
 			this.lblRunAheadFrames = new System.Windows.Forms.Label();
 			this.lblRunAhead = new System.Windows.Forms.Label();
+			this.chkRunAheadSecondInstance = new System.Windows.Forms.CheckBox();
 			this.label1 = new System.Windows.Forms.Label();
 			this.flowLayoutPanel9 = new System.Windows.Forms.FlowLayoutPanel();
 			this.nudTurboSpeed = new Mesen.GUI.Controls.MesenNumericUpDown();
@@ -134,6 +135,7 @@
 			this.tableLayoutPanel4.ColumnStyles.Add(new System.Windows.Forms.ColumnStyle(System.Windows.Forms.SizeType.Percent, 100F));
 			this.tableLayoutPanel4.Controls.Add(this.flowLayoutPanel5, 1, 4);
 			this.tableLayoutPanel4.Controls.Add(this.lblRunAhead, 0, 4);
+			this.tableLayoutPanel4.Controls.Add(this.chkRunAheadSecondInstance, 1, 5);
 			this.tableLayoutPanel4.Controls.Add(this.label1, 0, 3);
 			this.tableLayoutPanel4.Controls.Add(this.flowLayoutPanel9, 1, 1);
 			this.tableLayoutPanel4.Controls.Add(this.lblTurboSpeed, 0, 1);
@@ -145,7 +147,8 @@
 			this.tableLayoutPanel4.Dock = System.Windows.Forms.DockStyle.Fill;
 			this.tableLayoutPanel4.Location = new System.Drawing.Point(3, 3);
 			this.tableLayoutPanel4.Name = "tableLayoutPanel4";
-			this.tableLayoutPanel4.RowCount = 6;
+			this.tableLayoutPanel4.RowCount = 7;
+			this.tableLayoutPanel4.RowStyles.Add(new System.Windows.Forms.RowStyle());
 			this.tableLayoutPanel4.RowStyles.Add(new System.Windows.Forms.RowStyle());
 			this.tableLayoutPanel4.RowStyles.Add(new System.Windows.Forms.RowStyle());
 			this.tableLayoutPanel4.RowStyles.Add(new System.Windows.Forms.RowStyle());
@@ -218,6 +221,16 @@
 			this.lblRunAhead.TabIndex = 19;
 			this.lblRunAhead.Text = "Run Ahead:";
 			// 
+			// chkRunAheadSecondInstance
+			// 
+			this.chkRunAheadSecondInstance.AutoSize = true;
+			this.chkRunAheadSecondInstance.Location = new System.Drawing.Point(114, 138);
+			this.chkRunAheadSecondInstance.Name = "chkRunAheadSecondInstance";
+			this.chkRunAheadSecondInstance.Size = new System.Drawing.Size(276, 17);
+			this.chkRunAheadSecondInstance.TabIndex = 21;
+			this.chkRunAheadSecondInstance.Text = "Run ahead on a second instance (uses 2 CPU cores)";
+			this.chkRunAheadSecondInstance.UseVisualStyleBackColor = true;
+			// 
 			// label1
 			// 
 			this.label1.Anchor = System.Windows.Forms.AnchorStyles.Left;
@@ -917,6 +930,7 @@
 	  private Controls.MesenNumericUpDown nudRunAheadFrames;
 	  private System.Windows.Forms.Label lblRunAheadFrames;
 	  private System.Windows.Forms.Label lblRunAhead;
+	  private System.Windows.Forms.CheckBox chkRunAheadSecondInstance;
 	  private System.Windows.Forms.TabPage tpgBsx;
 	  private System.Windows.Forms.GroupBox grpBsxDateTime;
 	  private System.Windows.Forms.TableLayoutPanel tableLayoutPanel6;
@@ -29,6 +29,7 @@ namespace Mesen.GUI.Forms.Config
 			AddBinding(nameof(EmulationConfig.RewindSpeed), nudRewindSpeed);
 			AddBinding(nameof(EmulationConfig.Region), cboRegion);
 			AddBinding(nameof(EmulationConfig.RunAheadFrames), nudRunAheadFrames);
+			AddBinding(nameof(EmulationConfig.RunAheadSecondInstance), chkRunAheadSecondInstance);
 
 			AddBinding(nameof(EmulationConfig.RamPowerOnState), cboRamPowerOnState);
 			AddBinding(nameof(EmulationConfig.EnableRandomPowerOnState), chkEnableRandomPowerOnState);
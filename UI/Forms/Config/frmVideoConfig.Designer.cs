@@ -56,6 +56,7 @@
 			this.grpNtscFilter = new System.Windows.Forms.GroupBox();
 			this.tlpNtscFilter = new System.Windows.Forms.TableLayoutPanel();
 			this.chkMergeFields = new System.Windows.Forms.CheckBox();
+			this.chkForceLowRes = new System.Windows.Forms.CheckBox();
 			this.trkArtifacts = new Mesen.GUI.Controls.ctrlHorizontalTrackbar();
 			this.trkBleed = new Mesen.GUI.Controls.ctrlHorizontalTrackbar();
 			this.trkFringing = new Mesen.GUI.Controls.ctrlHorizontalTrackbar();
@@ -93,6 +94,7 @@
 			this.tpgAdvanced = new System.Windows.Forms.TabPage();
 			this.tableLayoutPanel2 = new System.Windows.Forms.TableLayoutPanel();
 			this.chkDisableFrameSkipping = new Mesen.GUI.Controls.ctrlRiskyOption();
+			this.chkUsePpuRenderThread = new System.Windows.Forms.CheckBox();
 			this.chkHideBgLayer0 = new Mesen.GUI.Controls.ctrlRiskyOption();
 			this.chkHideBgLayer1 = new Mesen.GUI.Controls.ctrlRiskyOption();
 			this.chkHideBgLayer2 = new Mesen.GUI.Controls.ctrlRiskyOption();
@@ -547,6 +549,7 @@
 			this.tlpNtscFilter.ColumnCount = 1;
 			this.tlpNtscFilter.ColumnStyles.Add(new System.Windows.Forms.ColumnStyle(System.Windows.Forms.SizeType.Percent, 100F));
 			this.tlpNtscFilter.Controls.Add(this.chkMergeFields, 0, 6);
+			this.tlpNtscFilter.Controls.Add(this.chkForceLowRes, 0, 7);
 			this.tlpNtscFilter.Controls.Add(this.trkArtifacts, 0, 0);
 			this.tlpNtscFilter.Controls.Add(this.trkBleed, 0, 1);
 			this.tlpNtscFilter.Controls.Add(this.trkFringing, 0, 2);
@@ -557,7 +560,7 @@
 			this.tlpNtscFilter.Location = new System.Drawing.Point(3, 16);
 			this.tlpNtscFilter.Margin = new System.Windows.Forms.Padding(0);
 			this.tlpNtscFilter.Name = "tlpNtscFilter";
-			this.tlpNtscFilter.RowCount = 7;
+			this.tlpNtscFilter.RowCount = 8;
 			this.tlpNtscFilter.RowStyles.Add(new System.Windows.Forms.RowStyle());
 			this.tlpNtscFilter.RowStyles.Add(new System.Windows.Forms.RowStyle());
 			this.tlpNtscFilter.RowStyles.Add(new System.Windows.Forms.RowStyle());
@@ -579,6 +582,16 @@
 			this.chkMergeFields.Text = "Merge Fields";
 			this.chkMergeFields.UseVisualStyleBackColor = true;
 			// 
+			// chkForceLowRes
+			// 
+			this.chkForceLowRes.AutoSize = true;
+			this.chkForceLowRes.Location = new System.Drawing.Point(3, 326);
+			this.chkForceLowRes.Name = "chkForceLowRes";
+			this.chkForceLowRes.Size = new System.Drawing.Size(231, 17);
+			this.chkForceLowRes.TabIndex = 31;
+			this.chkForceLowRes.Text = "Filter high resolution modes at 256 pixels";
+			this.chkForceLowRes.UseVisualStyleBackColor = true;
+			// 
 			// trkArtifacts
 			// 
 			this.trkArtifacts.Dock = System.Windows.Forms.DockStyle.Fill;
@@ -1164,6 +1177,7 @@
 			this.tableLayoutPanel2.ColumnCount = 1;
 			this.tableLayoutPanel2.ColumnStyles.Add(new System.Windows.Forms.ColumnStyle(System.Windows.Forms.SizeType.Percent, 100F));
 			this.tableLayoutPanel2.Controls.Add(this.chkDisableFrameSkipping, 0, 5);
+			this.tableLayoutPanel2.Controls.Add(this.chkUsePpuRenderThread, 0, 6);
 			this.tableLayoutPanel2.Controls.Add(this.chkHideBgLayer0, 0, 0);
 			this.tableLayoutPanel2.Controls.Add(this.chkHideBgLayer1, 0, 1);
 			this.tableLayoutPanel2.Controls.Add(this.chkHideBgLayer2, 0, 2);
@@ -1172,7 +1186,8 @@
 			this.tableLayoutPanel2.Dock = System.Windows.Forms.DockStyle.Fill;
 			this.tableLayoutPanel2.Location = new System.Drawing.Point(3, 3);
 			this.tableLayoutPanel2.Name = "tableLayoutPanel2";
-			this.tableLayoutPanel2.RowCount = 7;
+			this.tableLayoutPanel2.RowCount = 8;
+			this.tableLayoutPanel2.RowStyles.Add(new System.Windows.Forms.RowStyle());
 			this.tableLayoutPanel2.RowStyles.Add(new System.Windows.Forms.RowStyle());
 			this.tableLayoutPanel2.RowStyles.Add(new System.Windows.Forms.RowStyle());
 			this.tableLayoutPanel2.RowStyles.Add(new System.Windows.Forms.RowStyle());
@@ -1193,6 +1208,16 @@
 			this.chkDisableFrameSkipping.TabIndex = 5;
 			this.chkDisableFrameSkipping.Text = "Disable frame skipping when fast-forwarding";
 			// 
+			// chkUsePpuRenderThread
+			// 
+			this.chkUsePpuRenderThread.AutoSize = true;
+			this.chkUsePpuRenderThread.Location = new System.Drawing.Point(3, 147);
+			this.chkUsePpuRenderThread.Name = "chkUsePpuRenderThread";
+			this.chkUsePpuRenderThread.Size = new System.Drawing.Size(297, 17);
+			this.chkUsePpuRenderThread.TabIndex = 6;
+			this.chkUsePpuRenderThread.Text = "Render the picture on a separate thread (uses 2 CPU cores)";
+			this.chkUsePpuRenderThread.UseVisualStyleBackColor = true;
+			// 
 			// chkHideBgLayer0
 			// 
 			this.chkHideBgLayer0.Checked = false;
@@ -1364,6 +1389,7 @@
 		private System.Windows.Forms.GroupBox grpNtscFilter;
 		private System.Windows.Forms.TableLayoutPanel tlpNtscFilter;
 		private System.Windows.Forms.CheckBox chkMergeFields;
+		private System.Windows.Forms.CheckBox chkForceLowRes;
 		private Controls.ctrlHorizontalTrackbar trkArtifacts;
 		private Controls.ctrlHorizontalTrackbar trkBleed;
 		private Controls.ctrlHorizontalTrackbar trkFringing;
@@ -1410,6 +1436,7 @@
 		private Controls.ctrlRiskyOption chkHideBgLayer3;
 		private Controls.ctrlRiskyOption chkHideSprites;
 		private Controls.ctrlRiskyOption chkDisableFrameSkipping;
+		private System.Windows.Forms.CheckBox chkUsePpuRenderThread;
 		private System.Windows.Forms.CheckBox chkBlendHighResolutionModes;
 	  private System.Windows.Forms.FlowLayoutPanel flpResolution;
 	  private System.Windows.Forms.Label lblFullscreenResolution;
@@ -49,6 +49,7 @@ namespace Mesen.GUI.Forms.Config
 			AddBinding(nameof(VideoConfig.NtscResolution), trkResolution);
 			AddBinding(nameof(VideoConfig.NtscSharpness), trkSharpness);
 			AddBinding(nameof(VideoConfig.NtscMergeFields), chkMergeFields);
+			AddBinding(nameof(VideoConfig.NtscForceLowRes), chkForceLowRes);
 
 			AddBinding(nameof(VideoConfig.OverscanLeft), nudOverscanLeft);
 			AddBinding(nameof(VideoConfig.OverscanRight), nudOverscanRight);
@@ -61,6 +62,7 @@ namespace Mesen.GUI.Forms.Config
 			AddBinding(nameof(VideoConfig.HideBgLayer3), chkHideBgLayer3);
 			AddBinding(nameof(VideoConfig.HideSprites), chkHideSprites);
 			AddBinding(nameof(VideoConfig.DisableFrameSkipping), chkDisableFrameSkipping);
+			AddBinding(nameof(VideoConfig.UsePpuRenderThread), chkUsePpuRenderThread);
 
 			UpdateOverscanImage(picOverscan, 0, 0, 0, 0);
 
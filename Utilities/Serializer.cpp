@@ -8,18 +8,31 @@ Serializer::Serializer(uint32_t version)
 {
 	_version = version;
 
-	_block.reset(new BlockData());
-	_block->Data = vector<uint8_t>(0x50000);
-	_block->Position = 0;
+	_ownedData = vector<uint8_t>(0x50000);
+	_data = &_ownedData;
 	_saving = true;
 }
 
-Serializer::Serializer(istream &file, uint32_t version, bool compressed)
+Serializer::Serializer(uint32_t version, vector<uint8_t> &buffer)
+{
+	_version = version;
+
+	_data = &buffer;
+	_saving = true;
+}
+
+Serializer::Serializer(const uint8_t* data, uint32_t size, uint32_t version)
 {
 	_version = version;
 
-	_block.reset(new BlockData());
-	_block->Position = 0;
+	_readData = data;
+	_blockEnd = size;
+	_saving = false;
+}
+
+Serializer::Serializer(istream &file, uint32_t version, bool compressed)
+{
+	_version = version;
 	_saving = false;
 
 	if(compressed) {
@@ -32,36 +45,51 @@ Serializer::Serializer(istream &file, uint32_t version, bool compressed)
 		vector<uint8_t> compressedData(compressedSize, 0);
 		file.read((char*)compressedData.data(), compressedSize);
 
-		_block->Data = vector<uint8_t>(decompressedSize, 0);
+		_ownedData = vector<uint8_t>(decompressedSize, 0);
 
 		unsigned long decompSize = decompressedSize;
-		uncompress(_block->Data.data(), &decompSize, compressedData.data(), (unsigned long)compressedData.size());
+		uncompress(_ownedData.data(), &decompSize, compressedData.data(), (unsigned long)compressedData.size());
 	} else {
 		file.seekg(0, std::ios::end);
 		uint32_t size = (uint32_t)file.tellg();
 		file.seekg(0, std::ios::beg);
 
-		_block->Data = vector<uint8_t>(size, 0);
-		file.read((char*)_block->Data.data(), size);
+		_ownedData = vector<uint8_t>(size, 0);
+		file.read((char*)_ownedData.data(), size);
 	}
+
+	_readData = _ownedData.data();
+	_blockEnd = (uint32_t)_ownedData.size();
 }
 
 void Serializer::EnsureCapacity(uint32_t typeSize)
 {
-	//Make sure the current block/stream is large enough to fit the next write
-	uint32_t oldSize = (uint32_t)_block->Data.size();
-	if(oldSize == 0) {
-		oldSize = typeSize * 2;
+	//Make sure the buffer is large enough to fit the next write
+	uint32_t sizeRequired = _position + typeSize;
+	if(sizeRequired <= _data->size()) {
+		return;
 	}
 
-	uint32_t sizeRequired = _block->Position + typeSize;
-	
-	uint32_t newSize = oldSize;
+	uint32_t newSize = std::max<uint32_t>((uint32_t)_data->size(), typeSize * 2);
 	while(newSize < sizeRequired) {
 		newSize *= 2;
 	}
 
-	_block->Data.resize(newSize);
+	_data->resize(newSize);
+}
+
+void Serializer::StreamBytes(void* data, uint32_t size)
+{
+	if(_saving) {
+		EnsureCapacity(size);
+		memcpy(_data->data() + _position, data, size);
+		_position += size;
+	} else {
+		//Load as much as is available in the current block, the rest of the data is left untouched
+		uint32_t available = std::min(size, _blockEnd - _position);
+		memcpy(data, _readData + _position, available);
+		_position += available;
+	}
 }
 
 void Serializer::RecursiveStream()
@@ -70,48 +98,53 @@ void Serializer::RecursiveStream()
 
 void Serializer::StreamStartBlock()
 {
-	unique_ptr<BlockData> block(new BlockData());
-	block->Position = 0;
+	if(_blockDepth >= Serializer::MaxBlockDepth) {
+		throw std::runtime_error("Invalid call to start block");
+	}
 
-	if(!_saving) {
-		VectorInfo<uint8_t> vectorInfo = { &block->Data };
-		InternalStream(vectorInfo);
+	if(_saving) {
+		//Reserve space for the block's size, written once the block ends
+		_blockStack[_blockDepth++] = _position;
+		uint32_t blockSize = 0;
+		StreamElement<uint32_t>(blockSize);
 	} else {
-		block->Data = vector<uint8_t>(0x100);
-	}
+		uint32_t blockSize = 0;
+		StreamElement<uint32_t>(blockSize);
 
-	_blocks.push_back(std::move(_block));
-	_block = std::move(block);
+		_blockStack[_blockDepth++] = _blockEnd;
+		_blockEnd = _position + std::min(blockSize, _blockEnd - _position);
+	}
 }
 
 void Serializer::StreamEndBlock()
 {
-	if(_blocks.empty()) {
+	if(_blockDepth == 0) {
 		throw std::runtime_error("Invalid call to end block");
 	}
 
-	unique_ptr<BlockData> block = std::move(_block);
-
-	_block = std::move(_blocks.back());
-	_blocks.pop_back();
-
+	_blockDepth--;
 	if(_saving) {
-		ArrayInfo<uint8_t> arrayInfo { block->Data.data(), block->Position };
-		InternalStream(arrayInfo);
+		uint32_t sizePosition = _blockStack[_blockDepth];
+		uint32_t blockSize = _position - sizePosition - sizeof(uint32_t);
+		memcpy(_data->data() + sizePosition, &blockSize, sizeof(uint32_t));
+	} else {
+		//Skip any data in the block that was not read
+		_position = _blockEnd;
+		_blockEnd = _blockStack[_blockDepth];
 	}
 }
 
 void Serializer::Save(ostream& file, int compressionLevel)
 {
 	if(compressionLevel == 0) {
-		file.write((char*)_block->Data.data(), _block->Position);
+		file.write((char*)_data->data(), _position);
 	} else {
-		unsigned long compressedSize = compressBound((unsigned long)_block->Position);
+		unsigned long compressedSize = compressBound((unsigned long)_position);
 		uint8_t* compressedData = new uint8_t[compressedSize];
-		compress2(compressedData, &compressedSize, (unsigned char*)_block->Data.data(), (unsigned long)_block->Position, compressionLevel);
+		compress2(compressedData, &compressedSize, (unsigned char*)_data->data(), (unsigned long)_position, compressionLevel);
 
 		uint32_t size = (uint32_t)compressedSize;
-		file.write((char*)&_block->Position, sizeof(uint32_t));
+		file.write((char*)&_position, sizeof(uint32_t));
 		file.write((char*)&size, sizeof(uint32_t));
 		file.write((char*)compressedData, compressedSize);
 		delete[] compressedData;
@@ -147,10 +180,9 @@ void Serializer::Stream(ISerializable *obj)
 void Serializer::InternalStream(string &str)
 {
 	if(_saving) {
-		vector<uint8_t> stringData;
-		stringData.resize(str.size());
-		memcpy(stringData.data(), str.data(), str.size());
-		StreamVector(stringData);
+		uint32_t size = (uint32_t)str.size();
+		StreamElement<uint32_t>(size);
+		StreamBytes(&str[0], size);
 	} else {
 		vector<uint8_t> stringData;
 		StreamVector(stringData);
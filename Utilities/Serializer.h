@@ -25,23 +25,27 @@ struct ValueInfo
 	T DefaultValue;
 };
 
-struct BlockData
-{
-	vector<uint8_t> Data;
-	uint32_t Position;
-};
-
 class Serializer
 {
 private:
-	vector<unique_ptr<BlockData>> _blocks;	
-	unique_ptr<BlockData> _block;
+	vector<uint8_t> _ownedData;
+	vector<uint8_t>* _data = nullptr;
+	const uint8_t* _readData = nullptr;
+
+	uint32_t _position = 0;
+	uint32_t _blockEnd = 0;
+
+	//When saving: position of each open block's size field - when loading: end position of each parent block
+	static constexpr uint32_t MaxBlockDepth = 32;
+	uint32_t _blockStack[MaxBlockDepth];
+	uint32_t _blockDepth = 0;
 
 	uint32_t _version = 0;
 	bool _saving = false;
 
 private:
 	void EnsureCapacity(uint32_t typeSize);
+	void StreamBytes(void* data, uint32_t size);
 
 	template<typename T> void StreamElement(T &value, T defaultValue = T());
 	
@@ -61,8 +65,14 @@ public:
 	Serializer(uint32_t version);
 	Serializer(istream &file, uint32_t version, bool compressed = true);
 
+	//Saves into the given buffer, which is reused as-is (and only grown when too small) to avoid allocations
+	Serializer(uint32_t version, vector<uint8_t> &buffer);
+	//Loads directly from memory (uncompressed data), without copying it
+	Serializer(const uint8_t* data, uint32_t size, uint32_t version);
+
 	uint32_t GetVersion() { return _version; }
 	bool IsSaving() { return _saving; }
+	uint32_t GetSize() { return _position; }
 
 	template<typename... T> void Stream(T&... args);
 	template<typename T> void StreamArray(T *array, uint32_t size);
@@ -81,20 +91,16 @@ template<typename T>
 void Serializer::StreamElement(T &value, T defaultValue)
 {
 	if(_saving) {
-		uint8_t* bytes = (uint8_t*)&value;
-		int typeSize = sizeof(T);
-
-		EnsureCapacity(typeSize);
-		for(int i = 0; i < typeSize; i++) {
-			_block->Data[_block->Position++] = bytes[i];
-		}
+		EnsureCapacity(sizeof(T));
+		memcpy(_data->data() + _position, &value, sizeof(T));
+		_position += sizeof(T);
 	} else {
-		if(_block->Position + sizeof(T) <= _block->Data.size()) {
-			memcpy(&value, _block->Data.data() + _block->Position, sizeof(T));
-			_block->Position += sizeof(T);
+		if(_position + sizeof(T) <= _blockEnd) {
+			memcpy(&value, _readData + _position, sizeof(T));
+			_position += sizeof(T);
 		} else {
 			value = defaultValue;
-			_block->Position = (uint32_t)_block->Data.size();
+			_position = _blockEnd;
 		}
 	}
 }
@@ -111,14 +117,7 @@ void Serializer::InternalStream(ArrayInfo<T> &info)
 	}
 
 	//Load the number of elements requested, or the maximum possible (based on what is present in the save state)
-	EnsureCapacity(info.ElementCount * sizeof(T));
-
-	if(_saving) {
-		memcpy(_block->Data.data() + _block->Position, info.Array, info.ElementCount * sizeof(T));
-	} else {
-		memcpy(info.Array, _block->Data.data() + _block->Position, info.ElementCount * sizeof(T));
-	}
-	_block->Position += info.ElementCount * sizeof(T);
+	StreamBytes(info.Array, info.ElementCount * sizeof(T));
 }
 
 template<typename T>
@@ -138,11 +137,7 @@ void Serializer::InternalStream(VectorInfo<T> &info)
 	}
 
 	//Load the number of elements requested
-	T* pointer = vector->data();
-	for(uint32_t i = 0; i < count; i++) {
-		StreamElement<T>(*pointer);
-		pointer++;
-	}
+	StreamBytes(vector->data(), count * sizeof(T));
 }
 
 template<typename T>
@@ -0,0 +1,11 @@
+#pragma once
+
+//SIMD instruction sets are selected at compile time (there are no per-file ISA flags in the build)
+//SSE2 is always available on x64 - code paths that use it must have a regular fallback for other platforms
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define HAS_SSE2
+	#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+	#define HAS_NEON
+	#include <arm_neon.h>
+#endif
@@ -0,0 +1,187 @@
+#include "stdafx.h"
+#include <cmath>
+#include "SincResampler.h"
+#include "SimdUtilities.h"
+
+static double BesselI0(double x)
+{
+	//Power series, converges quickly for the window's range of values
+	double sum = 1.0;
+	double term = 1.0;
+	for(int k = 1; k < 50; k++) {
+		term *= (x / (2 * k)) * (x / (2 * k));
+		sum += term;
+		if(term < sum * 1e-12) {
+			break;
+		}
+	}
+	return sum;
+}
+
+void SincResampler::SetTapCount(uint32_t tapCount)
+{
+	tapCount = std::max<uint32_t>(8, std::min(SincResampler::MaxTapCount, tapCount & ~0x07));
+	if(tapCount != _tapCount) {
+		//The filter is rebuilt on the next call to SetSampleRates or Resample
+		_tapCount = tapCount;
+		_coefs.clear();
+		Reset();
+	}
+}
+
+uint32_t SincResampler::GetTapCount()
+{
+	return _tapCount;
+}
+
+void SincResampler::Reset()
+{
+	memset(_history, 0, sizeof(_history));
+	_historyPos = 0;
+	_fraction = 0.0;
+}
+
+void SincResampler::BuildFilter(double cutoff)
+{
+	constexpr double pi = 3.14159265358979323846;
+
+	//Shorter filters need a wider transition band (lower cutoff & window beta) to keep aliasing low
+	double beta = _tapCount <= 8 ? 5.0 : (_tapCount <= 16 ? 7.0 : 8.6);
+	double rolloff = _tapCount <= 8 ? 0.80 : (_tapCount <= 16 ? 0.88 : 0.93);
+	double fc = cutoff * rolloff;
+	double half = _tapCount / 2;
+	double i0Beta = BesselI0(beta);
+
+	_cutoff = cutoff;
+	_coefs.resize((PhaseCount + 1) * _tapCount);
+	_coefDeltas.resize(PhaseCount * _tapCount);
+
+	for(uint32_t phase = 0; phase <= PhaseCount; phase++) {
+		float* row = &_coefs[phase * _tapCount];
+		double sum = 0;
+		for(uint32_t i = 0; i < _tapCount; i++) {
+			//Distance between the tap's sample and the output's position (between samples half-1 and half)
+			double t = (double)i - half + 1 - (double)phase / PhaseCount;
+			double x = 2 * fc * t;
+			double sinc = x == 0 ? 1.0 : std::sin(pi * x) / (pi * x);
+			double w = t / half;
+			double window = std::abs(w) >= 1.0 ? 0.0 : BesselI0(beta * std::sqrt(1 - w * w)) / i0Beta;
+			row[i] = (float)(sinc * window);
+			sum += row[i];
+		}
+
+		//Normalize each phase to unity gain (avoids a DC ripple as the phase changes)
+		for(uint32_t i = 0; i < _tapCount; i++) {
+			row[i] = (float)(row[i] / sum);
+		}
+	}
+
+	for(uint32_t i = 0; i < PhaseCount * _tapCount; i++) {
+		_coefDeltas[i] = _coefs[i + _tapCount] - _coefs[i];
+	}
+}
+
+void SincResampler::SetSampleRates(double srcRate, double dstRate)
+{
+	_rateRatio = srcRate / dstRate;
+
+	//Cutoff is at the lowest of the 2 rates' nyquist frequency (in cycles per source sample)
+	//The dynamic rate adjustment makes the ratio constantly change by a tiny amount, so the filter is only rebuilt for larger changes
+	double cutoff = 0.5 * std::min(1.0, 1.0 / _rateRatio);
+	if(_coefs.empty() || std::abs(cutoff - _cutoff) > _cutoff * 0.01) {
+		BuildFilter(cutoff);
+	}
+}
+
+void SincResampler::PushSample(int16_t left, int16_t right)
+{
+	//History is duplicated so that the last _tapCount samples are always contiguous (oldest first, starting at _historyPos)
+	_history[0][_historyPos] = _history[0][_historyPos + _tapCount] = left;
+	_history[1][_historyPos] = _history[1][_historyPos + _tapCount] = right;
+	_historyPos++;
+	if(_historyPos >= _tapCount) {
+		_historyPos = 0;
+	}
+}
+
+void SincResampler::Interpolate(double fraction, int16_t* out)
+{
+	double pos = fraction * PhaseCount;
+	uint32_t phase = std::min((uint32_t)pos, PhaseCount - 1);
+	float mu = (float)(pos - phase);
+
+	const float* coefs = &_coefs[phase * _tapCount];
+	const float* deltas = &_coefDeltas[phase * _tapCount];
+	const float* left = &_history[0][_historyPos];
+	const float* right = &_history[1][_historyPos];
+
+#if defined(HAS_SSE2)
+	__m128 vmu = _mm_set1_ps(mu);
+	__m128 sumLeft = _mm_setzero_ps();
+	__m128 sumRight = _mm_setzero_ps();
+	for(uint32_t i = 0; i < _tapCount; i += 4) {
+		__m128 c = _mm_add_ps(_mm_loadu_ps(coefs + i), _mm_mul_ps(_mm_loadu_ps(deltas + i), vmu));
+		sumLeft = _mm_add_ps(sumLeft, _mm_mul_ps(c, _mm_loadu_ps(left + i)));
+		sumRight = _mm_add_ps(sumRight, _mm_mul_ps(c, _mm_loadu_ps(right + i)));
+	}
+
+	//Horizontal sums, then round & saturate both channels to 16 bits at once
+	__m128 sums = _mm_add_ps(_mm_unpacklo_ps(sumLeft, sumRight), _mm_unpackhi_ps(sumLeft, sumRight));
+	sums = _mm_add_ps(sums, _mm_movehl_ps(sums, sums));
+	__m128i samples = _mm_packs_epi32(_mm_cvtps_epi32(sums), _mm_setzero_si128());
+	int32_t output = _mm_cvtsi128_si32(samples);
+	memcpy(out, &output, sizeof(output));
+#else
+	float sumLeft;
+	float sumRight;
+	#if defined(HAS_NEON)
+		float32x4_t vmu = vdupq_n_f32(mu);
+		float32x4_t accLeft = vdupq_n_f32(0);
+		float32x4_t accRight = vdupq_n_f32(0);
+		for(uint32_t i = 0; i < _tapCount; i += 4) {
+			float32x4_t c = vmlaq_f32(vld1q_f32(coefs + i), vld1q_f32(deltas + i), vmu);
+			accLeft = vmlaq_f32(accLeft, c, vld1q_f32(left + i));
+			accRight = vmlaq_f32(accRight, c, vld1q_f32(right + i));
+		}
+		float32x2_t sums = vpadd_f32(vadd_f32(vget_low_f32(accLeft), vget_high_f32(accLeft)), vadd_f32(vget_low_f32(accRight), vget_high_f32(accRight)));
+		sumLeft = vget_lane_f32(sums, 0);
+		sumRight = vget_lane_f32(sums, 1);
+	#else
+		sumLeft = 0;
+		sumRight = 0;
+		for(uint32_t i = 0; i < _tapCount; i++) {
+			float c = coefs[i] + deltas[i] * mu;
+			sumLeft += c * left[i];
+			sumRight += c * right[i];
+		}
+	#endif
+	out[0] = (int16_t)std::lrint(std::max(std::min(sumLeft, 32767.0f), -32768.0f));
+	out[1] = (int16_t)std::lrint(std::max(std::min(sumRight, 32767.0f), -32768.0f));
+#endif
+}
+
+uint32_t SincResampler::Resample(int16_t* in, uint32_t inSampleCount, int16_t* out)
+{
+	//Unlike HermiteResampler, there is no shortcut for a 1:1 ratio: the filter's output is delayed by half its length,
+	//so switching between a plain copy and the filter (as the dynamic rate adjustment moves the ratio around 1.0) would cause clicks
+	if(_coefs.empty()) {
+		SetSampleRates(_rateRatio, 1.0);
+	}
+
+	uint32_t outPos = 0;
+
+	for(uint32_t i = 0; i < inSampleCount * 2; i += 2) {
+		while(_fraction <= 1.0) {
+			//Generate interpolated samples until we have enough samples for the current source sample
+			Interpolate(_fraction, out + outPos);
+			outPos += 2;
+			_fraction += _rateRatio;
+		}
+
+		//Move to the next source sample
+		PushSample(in[i], in[i + 1]);
+		_fraction -= 1.0;
+	}
+
+	return outPos / 2;
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include "stdafx.h"
+
+//Windowed-sinc (Kaiser) polyphase resampler, used as a higher quality alternative to HermiteResampler.
+//The filter is stored as a table of PhaseCount+1 phases, the coefficients for positions between 2 phases are linearly interpolated,
+//which allows any (and constantly changing) rate ratio without rebuilding the table.
+class SincResampler
+{
+public:
+	static constexpr uint32_t MaxTapCount = 32;
+
+private:
+	static constexpr uint32_t PhaseCount = 128;
+
+	uint32_t _tapCount = 16;
+	vector<float> _coefs;
+	vector<float> _coefDeltas;
+	double _cutoff = 0;
+
+	float _history[2][MaxTapCount * 2] = {};
+	uint32_t _historyPos = 0;
+
+	double _rateRatio = 1.0;
+	double _fraction = 0.0;
+
+	void BuildFilter(double cutoff);
+	__forceinline void PushSample(int16_t left, int16_t right);
+	__forceinline void Interpolate(double fraction, int16_t* out);
+
+public:
+	//Tap count must be a multiple of 8 (the higher the count, the sharper the filter and the higher the cost)
+	void SetTapCount(uint32_t tapCount);
+	uint32_t GetTapCount();
+
+	void Reset();
+
+	void SetSampleRates(double srcRate, double dstRate);
+	uint32_t Resample(int16_t* in, uint32_t inSampleCount, int16_t* out);
+};
@@ -0,0 +1,104 @@
+#pragma once
+#include "stdafx.h"
+
+//Wait-free ring buffer for a single producer thread and a single consumer thread (e.g emulation thread -> audio callback)
+//The read & write positions are free-running counters (the buffer's size is a power of 2) that are each only updated by one thread.
+//They are kept on separate cache lines so the 2 threads don't keep invalidating each other's cache line.
+class SpscRingBuffer
+{
+private:
+	static constexpr size_t CacheLineSize = 64;
+
+	//Producer side
+	alignas(CacheLineSize) atomic<uint32_t> _writePosition;
+	uint32_t _cachedReadPosition = 0;
+
+	//Consumer side
+	alignas(CacheLineSize) atomic<uint32_t> _readPosition;
+	uint32_t _cachedWritePosition = 0;
+
+	alignas(CacheLineSize) uint8_t* _buffer = nullptr;
+	uint32_t _size = 0;
+	uint32_t _mask = 0;
+
+public:
+	SpscRingBuffer()
+	{
+		_writePosition = 0;
+		_readPosition = 0;
+	}
+
+	~SpscRingBuffer()
+	{
+		delete[] _buffer;
+	}
+
+	//Not thread-safe: neither thread can access the buffer while it is being reset
+	void Reset(uint32_t minSize)
+	{
+		uint32_t size = 1;
+		while(size < minSize) {
+			size <<= 1;
+		}
+
+		if(size != _size) {
+			delete[] _buffer;
+			_buffer = new uint8_t[size];
+			_size = size;
+			_mask = size - 1;
+		}
+		memset(_buffer, 0, _size);
+
+		_writePosition = 0;
+		_readPosition = 0;
+		_cachedReadPosition = 0;
+		_cachedWritePosition = 0;
+	}
+
+	uint32_t GetSize()
+	{
+		return _size;
+	}
+
+	//Number of bytes waiting to be read - can be called from either thread
+	uint32_t GetUsedBytes()
+	{
+		return _writePosition.load(std::memory_order_acquire) - _readPosition.load(std::memory_order_acquire);
+	}
+
+	//Producer: returns the number of bytes that were written (less than len when the buffer is full)
+	uint32_t Write(const uint8_t* input, uint32_t len)
+	{
+		uint32_t writePosition = _writePosition.load(std::memory_order_relaxed);
+		if(_size - (writePosition - _cachedReadPosition) < len) {
+			_cachedReadPosition = _readPosition.load(std::memory_order_acquire);
+			len = std::min(len, _size - (writePosition - _cachedReadPosition));
+		}
+
+		uint32_t offset = writePosition & _mask;
+		uint32_t firstPart = std::min(len, _size - offset);
+		memcpy(_buffer + offset, input, firstPart);
+		memcpy(_buffer, input + firstPart, len - firstPart);
+
+		_writePosition.store(writePosition + len, std::memory_order_release);
+		return len;
+	}
+
+	//Consumer: returns the number of bytes that were read (less than len when the buffer runs out of data)
+	uint32_t Read(uint8_t* output, uint32_t len)
+	{
+		uint32_t readPosition = _readPosition.load(std::memory_order_relaxed);
+		if(_cachedWritePosition - readPosition < len) {
+			_cachedWritePosition = _writePosition.load(std::memory_order_acquire);
+			len = std::min(len, _cachedWritePosition - readPosition);
+		}
+
+		uint32_t offset = readPosition & _mask;
+		uint32_t firstPart = std::min(len, _size - offset);
+		memcpy(output, _buffer + offset, firstPart);
+		memcpy(output + firstPart, _buffer, len - firstPart);
+
+		_readPosition.store(readPosition + len, std::memory_order_release);
+		return len;
+	}
+};